@@ -0,0 +1,36 @@
+// Measures DistinctCounter::Add over many passes of the same ULIDs, around the
+// sparse limit of the default precision.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "ulid.h"
+
+int main() {
+	const ulid::Philox4x32 generator(4);
+	constexpr int kPasses = 100;
+
+	std::printf("%8s %8s %10s %10s\n", "distinct", "passes", "ns/add", "estimate");
+
+	for (std::size_t n : {4090, 4096, 100000}) {
+		std::vector<ulid::ULID> ulids(n);
+		for (std::size_t i = 0; i < n; i++) {
+			ulid::EncodeEntropyPhilox(generator, i, ulids[i]);
+		}
+
+		ulid::DistinctCounter counter;
+		const auto start = std::chrono::steady_clock::now();
+		for (int pass = 0; pass < kPasses; pass++) {
+			for (const ulid::ULID& ulid : ulids) {
+				counter.Add(ulid);
+			}
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+		std::printf("%8zu %8d %10.1f %10llu\n", n, kPasses, elapsed.count() / static_cast<double>(n * kPasses),
+								static_cast<unsigned long long>(counter.Estimate()));
+	}
+
+	return 0;
+}
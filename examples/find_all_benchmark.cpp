@@ -0,0 +1,66 @@
+// Measures the throughput of FindAll on generated log lines mixing short
+// alphanumeric runs, JSON and embedded ULIDs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "ulid.h"
+
+namespace {
+
+const std::size_t kBytes = std::size_t{256} << 20;
+const int kRounds				 = 5;
+
+const char* const kLevels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+const char* const kPaths[]	= {"/api/v1/items", "/api/v2/users/search", "/healthz", "/static/app.js"};
+
+}	 // namespace
+
+int main() {
+	const auto epoch = std::chrono::system_clock::now();
+	const ulid::Philox4x32 generator(4);
+
+	std::string text;
+	text.reserve(kBytes + 512);
+
+	std::size_t expected = 0;
+	for (uint64_t i = 0; text.size() < kBytes; i++) {
+		const std::array<uint32_t, 4> block = generator(i);
+
+		ulid::ULID request = 0;
+		ulid::EncodeTime(epoch + std::chrono::milliseconds(i), request);
+		ulid::EncodeEntropyPhilox(generator, i, request);
+
+		char line[512];
+		const int n = std::snprintf(
+				line, sizeof(line),
+				"2026-10-18T12:%02u:%02u.%03uZ %s pid=%u request_id=%s method=GET path=%s/%u status=%u "
+				"latency_ms=%u {\"trace\":\"%08x%08x\",\"user\":\"user%u\",\"retry\":false}\n",
+				block[0] % 60, block[1] % 60, block[2] % 1000, kLevels[block[3] % 4], block[0] % 32768,
+				ulid::Marshal(request).c_str(), kPaths[block[1] % 4], block[2] % 100000,
+				block[3] % 2 != 0 ? 200U : 404U, block[0] % 2000, block[1], block[2], block[3] % 1000);
+		text.append(line, static_cast<std::size_t>(n));
+		expected++;
+	}
+
+	double best = 1e9;
+	for (int round = 0; round < kRounds; round++) {
+		std::size_t found = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+		ulid::FindAll(text, [&found](ulid::ULID, std::size_t) { found++; });
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (found != expected) {
+			std::fprintf(stderr, "found %zu ULIDs, expected %zu\n", found, expected);
+			return 1;
+		}
+		best = std::min(best, elapsed.count());
+	}
+
+	std::printf("%zu MiB, %zu ULIDs: %.3fs, %.2f GB/s\n", text.size() >> 20, expected, best,
+							static_cast<double>(text.size()) / best / 1e9);
+	return 0;
+}
@@ -0,0 +1,63 @@
+// Compares InterpolationLowerBound with std::lower_bound on sorted ULIDs
+// whose timestamps are uniform over a day.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "ulid.h"
+
+namespace {
+
+const std::size_t kLookups = 1000000;
+
+template <typename Search>
+double Run(const std::vector<ulid::ULID>& keys, std::size_t& checksum, Search search) {
+	const auto start = std::chrono::steady_clock::now();
+	for (const ulid::ULID& key : keys) {
+		checksum += search(key);
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}	 // namespace
+
+int main() {
+	const auto epoch = std::chrono::system_clock::now();
+	const ulid::Philox4x32 generator(4);
+
+	std::printf("%10s %14s %14s %8s\n", "n", "lower_bound", "interpolation", "speedup");
+
+	for (std::size_t n : {1000000, 4000000, 20000000}) {
+		std::vector<ulid::ULID> ulids(n);
+		ulid::GenerateParallel(ulids, 4, [&](std::size_t i) {
+			return epoch + std::chrono::milliseconds(generator(i)[3] % 86400000);
+		});
+		std::sort(ulids.begin(), ulids.end());
+
+		std::vector<ulid::ULID> keys(kLookups);
+		ulid::GenerateParallel(keys, 5, [&](std::size_t i) {
+			return epoch + std::chrono::milliseconds(generator(n + i)[3] % 86400000);
+		});
+
+		std::size_t binary_sum				= 0;
+		std::size_t interpolation_sum = 0;
+
+		const double binary = Run(keys, binary_sum, [&](const ulid::ULID& key) {
+			return static_cast<std::size_t>(std::lower_bound(ulids.begin(), ulids.end(), key) -
+																			ulids.begin());
+		});
+		const double interpolation = Run(keys, interpolation_sum, [&](const ulid::ULID& key) {
+			return ulid::InterpolationLowerBound(ulids, key);
+		});
+
+		if (binary_sum != interpolation_sum) {
+			std::fprintf(stderr, "results differ\n");
+			return 1;
+		}
+		std::printf("%10zu %13.3fs %13.3fs %7.2fx\n", n, binary, interpolation, binary / interpolation);
+	}
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+// Compares MergeK with a std::priority_queue based k-way merge of sorted runs
+// of random ULIDs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "ulid.h"
+
+namespace {
+
+std::size_t MergePriorityQueue(std::span<const std::span<const ulid::ULID>> inputs,
+															 std::span<ulid::ULID> out) {
+	using Entry = std::pair<ulid::ULID, std::size_t>;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+	std::vector<std::size_t> positions(inputs.size(), 0);
+
+	for (std::size_t i = 0; i < inputs.size(); i++) {
+		if (!inputs[i].empty()) {
+			queue.emplace(inputs[i][0], i);
+		}
+	}
+
+	std::size_t n = 0;
+	while (!queue.empty()) {
+		const auto [ulid, i] = queue.top();
+		queue.pop();
+		out[n++] = ulid;
+		if (++positions[i] < inputs[i].size()) {
+			queue.emplace(inputs[i][positions[i]], i);
+		}
+	}
+	return n;
+}
+
+}	 // namespace
+
+int main() {
+	const ulid::Philox4x32 generator(4);
+
+	std::printf("%6s %8s %14s %14s %8s\n", "k", "per run", "priority_queue", "MergeK", "speedup");
+
+	for (auto [k, per_run] : {std::pair<std::size_t, std::size_t>{16, 640000}, {256, 40000}, {1024, 10000}}) {
+		std::vector<ulid::ULID> ulids(k * per_run);
+		ulid::GenerateParallel(ulids, 4, [&](std::size_t i) {
+			return std::chrono::system_clock::time_point(std::chrono::milliseconds(generator(i)[3]));
+		});
+
+		std::vector<std::span<const ulid::ULID>> inputs;
+		for (std::size_t i = 0; i < k; i++) {
+			auto run = std::span<ulid::ULID>(ulids).subspan(i * per_run, per_run);
+			std::sort(run.begin(), run.end());
+			inputs.emplace_back(run);
+		}
+
+		std::vector<ulid::ULID> expected(ulids.size());
+		std::vector<ulid::ULID> got(ulids.size());
+
+		auto start = std::chrono::steady_clock::now();
+		MergePriorityQueue(inputs, expected);
+		const std::chrono::duration<double> queue = std::chrono::steady_clock::now() - start;
+
+		start = std::chrono::steady_clock::now();
+		ulid::MergeK(inputs, got);
+		const std::chrono::duration<double> tree = std::chrono::steady_clock::now() - start;
+
+		if (expected != got) {
+			std::fprintf(stderr, "results differ\n");
+			return 1;
+		}
+		std::printf("%6zu %8zu %13.3fs %13.3fs %7.2fx\n", k, per_run, queue.count(), tree.count(),
+								queue.count() / tree.count());
+	}
+
+	return 0;
+}
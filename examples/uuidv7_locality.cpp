@@ -0,0 +1,147 @@
+// Compares the B-tree insert locality of random UUIDs, ULIDs and UUIDv7s.
+//
+// The leaf layer of a B+-tree is simulated with fixed capacity pages, located
+// through a map of each page's first key, behind a small LRU buffer pool. Like
+// SQLite, a page split at the right edge of the tree starts a new empty page
+// instead of splitting 50/50, so in order inserts leave full pages behind.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ulid.h"
+
+namespace {
+
+const std::size_t kInserts	= 1000000;
+const std::size_t kPageSize = 64;		// keys per leaf page
+const std::size_t kPoolSize = 256;	// leaf pages held by the buffer pool
+const std::size_t kPerMs		= 100;	// inserts per millisecond
+
+class LeafLayer {
+ public:
+	LeafLayer() : pages_(1) { index_[0] = 0; }
+
+	void Insert(const ulid::ULID& key) {
+		auto it						 = std::prev(index_.upper_bound(key));
+		const std::size_t id = it->second;
+		Touch(id);
+
+		std::vector<ulid::ULID>& page = pages_[id];
+		page.insert(std::lower_bound(page.begin(), page.end(), key), key);
+		if (page.size() <= kPageSize) {
+			return;
+		}
+
+		splits_++;
+		const bool rightmost = std::next(it) == index_.end() && page.back() == key;
+		const std::size_t keep = rightmost ? kPageSize : page.size() / 2;
+
+		std::vector<ulid::ULID> upper(page.begin() + static_cast<std::ptrdiff_t>(keep), page.end());
+		page.resize(keep);
+
+		index_[upper.front()] = pages_.size();
+		Touch(pages_.size());
+		pages_.push_back(std::move(upper));
+	}
+
+	std::size_t Pages() const { return pages_.size(); }
+
+	std::size_t Splits() const { return splits_; }
+
+	std::size_t Misses() const { return misses_; }
+
+	double Fill() const {
+		std::size_t keys = 0;
+		for (const auto& page : pages_) {
+			keys += page.size();
+		}
+		return static_cast<double>(keys) / static_cast<double>(pages_.size() * kPageSize);
+	}
+
+ private:
+	void Touch(std::size_t id) {
+		auto it = lru_index_.find(id);
+		if (it != lru_index_.end()) {
+			lru_.splice(lru_.begin(), lru_, it->second);
+			return;
+		}
+
+		misses_++;
+		lru_.push_front(id);
+		lru_index_[id] = lru_.begin();
+		if (lru_.size() > kPoolSize) {
+			lru_index_.erase(lru_.back());
+			lru_.pop_back();
+		}
+	}
+
+	std::map<ulid::ULID, std::size_t> index_;	 // first key of each page
+	std::vector<std::vector<ulid::ULID>> pages_;
+	std::list<std::size_t> lru_;
+	std::unordered_map<std::size_t, std::list<std::size_t>::iterator> lru_index_;
+	std::size_t splits_ = 0;
+	std::size_t misses_ = 0;
+};
+
+void Run(const char* name, const std::function<ulid::ULID(std::size_t)>& next) {
+	LeafLayer leaves;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < kInserts; i++) {
+		leaves.Insert(next(i));
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::printf("%-8s %10zu %10zu %9.1f%% %9.1f%% %9.2fs\n", name, leaves.Pages(), leaves.Splits(),
+							100.0 * leaves.Fill(),
+							100.0 * static_cast<double>(leaves.Misses()) / static_cast<double>(kInserts),
+							elapsed.count());
+}
+
+}	 // namespace
+
+int main() {
+	const auto epoch = std::chrono::system_clock::now();
+	const ulid::Philox4x32 generator(4);
+
+	auto timestamp = [&epoch](std::size_t i) {
+		return epoch + std::chrono::milliseconds(static_cast<int64_t>(i / kPerMs));
+	};
+
+	std::printf("%-8s %10s %10s %10s %10s %10s\n", "keys", "pages", "splits", "fill", "misses",
+							"time");
+
+	Run("random", [&](std::size_t i) {
+		const std::array<uint32_t, 4> block = generator(i);
+
+		ulid::ULID ulid = block[0];
+		for (std::size_t w = 1; w < block.size(); w++) {
+			ulid = (ulid << 32) | block[w];
+		}
+		return ulid;
+	});
+
+	Run("ulid", [&](std::size_t i) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(timestamp(i), ulid);
+		ulid::EncodeEntropyPhilox(generator, i, ulid);
+		return ulid;
+	});
+
+	Run("uuidv7", [&](std::size_t i) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(timestamp(i), ulid);
+		ulid::EncodeEntropyPhilox(generator, i, ulid);
+		ulid::EncodeUuidV7(ulid);
+		return ulid;
+	});
+
+	return 0;
+}
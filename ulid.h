@@ -48,12 +48,53 @@
   }  // namespace boost
 #endif
 
+// memory mapped checkpoints for PersistentGenerator are only available on POSIX
+#if __has_include(<sys/mman.h>) && __has_include(<sys/file.h>) && __has_include(<unistd.h>)
+  #define ULID_HAS_MMAP 1
+  #include <fcntl.h>
+  #include <sys/file.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#else
+  #define ULID_HAS_MMAP 0
+#endif
+
+// SSE2 (and AVX2 if enabled) is used to classify characters when scanning
+// text for ULIDs
+#if defined(__SSE2__) || defined(_M_X64)
+  #define ULID_HAS_SSE2 1
+  #include <emmintrin.h>
+#else
+  #define ULID_HAS_SSE2 0
+#endif
+
+#if defined(__AVX2__)
+  #define ULID_HAS_AVX2 1
+  #include <immintrin.h>
+#else
+  #define ULID_HAS_AVX2 0
+#endif
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <chrono>
+#include <cmath>
+#include <compare>
+#include <concepts>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <random>
 #include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
 #if _MSC_VER > 0
@@ -257,6 +298,131 @@ inline void EncodeEntropyMt19937(std::mt19937& generator, ULID& ulid) {
 	// NOLINTEND
 }
 
+/**
+ * Philox4x32 is the Philox4x32-10 counter-based random number generator from
+ * Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC '11).
+ *
+ * Every output block is a pure function of the seed and a counter, so the
+ * stream can be seeked to any position in O(1) and split across threads
+ * without changing its contents.
+ * */
+class Philox4x32 {
+ public:
+	explicit Philox4x32(uint64_t seed)
+			: key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}	// NOLINT
+
+	/**
+	 * operator() will return the 128 bit block at the passed counter.
+	 * */
+	std::array<uint32_t, 4> operator()(uint64_t counter) const {
+		// NOLINTBEGIN
+		std::array<uint32_t, 4> ctr = {static_cast<uint32_t>(counter),
+																	 static_cast<uint32_t>(counter >> 32), 0, 0};
+		std::array<uint32_t, 2> key = key_;
+
+		for (int round = 0; round < 10; round++) {
+			const uint64_t p0 = static_cast<uint64_t>(0xD2511F53) * ctr[0];
+			const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57) * ctr[2];
+
+			ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+						 static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+
+			key[0] += 0x9E3779B9;
+			key[1] += 0xBB67AE85;
+		}
+
+		return ctr;
+		// NOLINTEND
+	}
+
+ private:
+	std::array<uint32_t, 2> key_;
+};
+
+/**
+ * EncodeEntropyPhilox will encode a ulid using the block of the passed
+ * Philox4x32 generator at the passed counter.
+ * */
+inline void EncodeEntropyPhilox(const Philox4x32& generator, uint64_t counter, ULID& ulid) {
+	// NOLINTBEGIN
+	ulid = (ulid >> 80) << 80;
+
+	const std::array<uint32_t, 4> block = generator(counter);
+
+	ULID e = static_cast<uint16_t>(block[0]);
+
+	e <<= 32;
+	e |= block[1];
+
+	e <<= 32;
+	e |= block[2];
+
+	ulid |= e;
+	// NOLINTEND
+}
+
+/**
+ * GenerateParallel will fill the passed span with ULIDs, using the passed
+ * threads (or std::thread::hardware_concurrency() if 0).
+ *
+ * The ULID at index i is timestamp_fn(i) encoded with the entropy of a
+ * Philox4x32 seeded with seed at counter i, so the result is identical for
+ * every thread count. timestamp_fn is called concurrently and must be safe to
+ * do so. If it throws, every thread is joined before the first exception (in
+ * index order) is rethrown, leaving the span partially filled.
+ * */
+inline void GenerateParallel(
+		std::span<ULID> ulids, uint64_t seed,
+		const std::function<std::chrono::time_point<std::chrono::system_clock>(std::size_t)>&
+				timestamp_fn,
+		unsigned threads = 0) {
+	const Philox4x32 generator(seed);
+
+	auto fill = [&](std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; i++) {
+			EncodeTime(timestamp_fn(i), ulids[i]);
+			EncodeEntropyPhilox(generator, i, ulids[i]);
+		}
+	};
+
+	if (threads == 0) {
+		threads = std::max(1U, std::thread::hardware_concurrency());
+	}
+	threads = static_cast<unsigned>(std::min<std::size_t>(threads, ulids.size()));
+	if (threads <= 1) {
+		fill(0, ulids.size());
+		return;
+	}
+
+	const std::size_t chunk = (ulids.size() + threads - 1) / threads;
+
+	// declared before the workers so it outlives them, every worker stores the
+	// exception (if any) that ended its chunk
+	std::vector<std::exception_ptr> errors((ulids.size() + chunk - 1) / chunk);
+	{
+		// std::jthread joins on destruction, also while unwinding from a failed
+		// emplace_back
+		std::vector<std::jthread> workers;
+		workers.reserve(errors.size());
+
+		for (std::size_t i = 0; i < errors.size(); i++) {
+			workers.emplace_back([&, i]() {
+				try {
+					fill(i * chunk, std::min((i + 1) * chunk, ulids.size()));
+				} catch (...) {
+					errors[i] = std::current_exception();
+				}
+			});
+		}
+	}
+
+	for (const std::exception_ptr& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
 /**
  * Encode will create an encoded ULID with a timestamp and a generator.
  * */
@@ -447,6 +613,73 @@ inline boost::uuids::uuid MarshalUuid(const ULID& ulid) {
 	return uuid;
 }
 
+/**
+ * EncodeUuidV7 will set the RFC 9562 version (7) and variant (0b10) bits on
+ * the passed ULID, overwriting 6 of its entropy bits. The 48 bit timestamp is
+ * already laid out as the unix_ts_ms field of a UUIDv7 and is left as is.
+ * */
+inline void EncodeUuidV7(ULID& ulid) {
+	// NOLINTBEGIN
+	ulid &= ~(static_cast<ULID>(0xF) << 76);
+	ulid |= static_cast<ULID>(0x7) << 76;
+
+	ulid &= ~(static_cast<ULID>(0x3) << 62);
+	ulid |= static_cast<ULID>(0x2) << 62;
+	// NOLINTEND
+}
+
+/**
+ * IsUuidV7 will check whether the passed ULID has the RFC 9562 version and
+ * variant bits of a UUIDv7 set.
+ * */
+inline bool IsUuidV7(const ULID& ulid) {
+	// NOLINTBEGIN
+	return static_cast<uint8_t>((ulid >> 76) & 0xF) == 0x7 &&
+				 static_cast<uint8_t>((ulid >> 62) & 0x3) == 0x2;
+	// NOLINTEND
+}
+
+/**
+ * CreateUuidV7 = Create + EncodeUuidV7.
+ * */
+inline ULID CreateUuidV7(std::chrono::time_point<std::chrono::system_clock> timestamp,
+												 const std::function<uint8_t()>& rng) {
+	ULID ulid = Create(timestamp, rng);
+	EncodeUuidV7(ulid);
+	return ulid;
+}
+
+/**
+ * CreateNowRandUuidV7 will create a UUIDv7 compatible ULID using
+ * EncodeTimeSystemClockNow and EncodeEntropyRand.
+ * */
+inline ULID CreateNowRandUuidV7() {
+	ULID ulid = 0;
+	EncodeTimeSystemClockNow(ulid);
+	EncodeEntropyRand(ulid);
+	EncodeUuidV7(ulid);
+	return ulid;
+}
+
+/**
+ * MarshalUuidV7 will marshal every ULID of the passed span to a UUIDv7 in
+ * the passed span of the same size, setting the version and variant bits.
+ *
+ * Those 6 bits overwrite entropy, so unmarshalling the UUIDv7 only returns
+ * the original ULID if it already had them set, e.g. from CreateUuidV7.
+ * */
+inline void MarshalUuidV7(std::span<const ULID> ulids, std::span<boost::uuids::uuid> uuids) {
+	if (ulids.size() != uuids.size()) {
+		throw std::runtime_error("MarshalUuidV7 spans must be of the same size");
+	}
+
+	for (std::size_t i = 0; i < ulids.size(); i++) {
+		ULID ulid = ulids[i];
+		EncodeUuidV7(ulid);
+		uuids[i] = MarshalUuid(ulid);
+	}
+}
+
 /**
  * dec storesdecimal encodings for characters.
  * 0xFF indicates invalid character.
@@ -556,6 +789,169 @@ inline void UnmarshalFrom(const std::string_view str, ULID& ulid) {
 	return ulid;
 }
 
+/**
+ * AlphabetMask will return a bit mask with bit i set if data[i] is one of the
+ * characters accepted by dec, for up to 64 characters.
+ *
+ * Characters are classified 32 at a time with AVX2 and 16 at a time with
+ * SSE2 when available, then 8 at a time within a 64 bit word, the rest
+ * using dec.
+ * */
+inline uint64_t AlphabetMask(const char* data, std::size_t len) {
+	// NOLINTBEGIN
+	uint64_t mask = 0;
+	std::size_t i = 0;
+
+#if ULID_HAS_AVX2
+	for (; i + 32 <= len; i += 32) {
+		const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+		const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+																					 _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+		const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+																					 _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+		const __m256i excluded =
+				_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('I')),
+																				_mm256_cmpeq_epi8(c, _mm256_set1_epi8('L'))),
+												_mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('O')),
+																				_mm256_cmpeq_epi8(c, _mm256_set1_epi8('U'))));
+
+		const __m256i valid = _mm256_or_si256(digit, _mm256_andnot_si256(excluded, upper));
+		mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(valid))) << i;
+	}
+#endif
+
+#if ULID_HAS_SSE2
+	for (; i + 16 <= len; i += 16) {
+		const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+		const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+																				_mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+		const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('A' - 1)),
+																				_mm_cmplt_epi8(c, _mm_set1_epi8('Z' + 1)));
+		const __m128i excluded =
+				_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('I')),
+																	_mm_cmpeq_epi8(c, _mm_set1_epi8('L'))),
+										 _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('O')),
+																	_mm_cmpeq_epi8(c, _mm_set1_epi8('U'))));
+
+		const __m128i valid = _mm_or_si128(digit, _mm_andnot_si128(excluded, upper));
+		mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(valid))) << i;
+	}
+#endif
+
+	// SWAR: classify 8 characters per 64 bit word, with the result in the high
+	// bit of every byte (bytes of 0x80 and above are never accepted)
+	if constexpr (std::endian::native == std::endian::little) {
+		constexpr uint64_t kOnes = 0x0101010101010101ULL;
+		constexpr uint64_t kHigh = 0x8080808080808080ULL;
+
+		auto at_least = [](uint64_t y, uint8_t c) { return (y + (0x80 - c) * kOnes) & kHigh; };
+		auto not_equal = [](uint64_t y, uint8_t c) {
+			return ((y ^ (c * kOnes)) + 0x7F * kOnes) & kHigh;
+		};
+
+		for (; i + 8 <= len; i += 8) {
+			uint64_t x = 0;
+			std::memcpy(&x, data + i, sizeof(x));
+			const uint64_t y = x & ~kHigh;
+
+			const uint64_t digit = at_least(y, '0') & ~at_least(y, '9' + 1);
+			const uint64_t upper = at_least(y, 'A') & ~at_least(y, 'Z' + 1) & not_equal(y, 'I') &
+														 not_equal(y, 'L') & not_equal(y, 'O') & not_equal(y, 'U');
+			const uint64_t valid = (digit | upper) & ~x & kHigh;
+
+			// gathers the high bit of byte k into bit k
+			mask |= (((valid >> 7) * 0x0102040810204080ULL) >> 56) << i;
+		}
+	}
+
+	for (; i < len; i++) {
+		mask |= static_cast<uint64_t>(dec[static_cast<uint8_t>(data[i])] != 0xFF) << i;
+	}
+	return mask;
+	// NOLINTEND
+}
+
+/**
+ * FindAll will call callback(ulid, offset) for every ULID embedded in the
+ * passed buffer and return the number of ULIDs found.
+ *
+ * A ULID is a run of exactly 26 characters accepted by dec, bounded by
+ * characters that are not (or the ends of the buffer), whose first character
+ * does not overflow the 48 bit timestamp.
+ *
+ * The buffer is classified 64 characters at a time using AlphabetMask. Joined
+ * with the mask of the following 64 characters, and-ing the mask with shifted
+ * copies of itself marks every position starting 26 accepted characters.
+ * Keeping only run starts (accepted characters whose predecessor, carried
+ * over from the previous block, is not) that are followed by a rejected
+ * character 26 positions later leaves the runs of exactly 26. Only those
+ * positions are visited, validated and decoded.
+ * */
+template <typename Callback>
+	requires std::invocable<Callback&, ULID, std::size_t>
+inline std::size_t FindAll(std::string_view buffer, Callback&& callback) {
+	// NOLINTBEGIN
+	const char* data			= buffer.data();
+	const std::size_t len = buffer.size();
+
+	std::size_t count = 0;
+	uint64_t carry		= 0;	// whether the character before the block is accepted
+	uint64_t mask			= AlphabetMask(data, std::min<std::size_t>(64, len));
+
+	for (std::size_t base = 0; base < len; base += 64) {
+		const uint64_t next =
+				base + 64 < len ? AlphabetMask(data + base + 64, std::min<std::size_t>(64, len - base - 64))
+												: 0;
+		const ULID window = (static_cast<ULID>(next) << 64) | mask;
+
+		// bit i of full is set if the 26 characters from i on are accepted
+		ULID full = window & (window >> 1);
+		full &= full >> 2;
+		full &= full >> 4;
+		full &= full >> 8;
+		full &= full >> 10;
+
+		// a run starts where the previous character is not accepted and ends
+		// where the next one is not
+		const ULID starts		 = window & ~((window << 1) | carry);
+		const ULID not_after = ~(window >> STR_SIZE);
+
+		for (uint64_t exact = static_cast<uint64_t>(full & starts & not_after); exact != 0;
+				 exact &= exact - 1) {
+			const std::size_t offset = base + static_cast<std::size_t>(std::countr_zero(exact));
+			const std::string_view str(data + offset, STR_SIZE);
+			if (dec[static_cast<uint8_t>(str[0])] > 7) {
+				continue;
+			}
+
+			ULID ulid = 0;
+			UnmarshalFrom(str, ulid);
+			callback(ulid, offset);
+			count++;
+		}
+
+		carry = mask >> 63;
+		mask	= next;
+	}
+	return count;
+	// NOLINTEND
+}
+
+/**
+ * FindAll will write the ULIDs embedded in the passed buffer to the passed
+ * span and return the number of ULIDs found. If more ULIDs are found than fit
+ * in the span, only the first ulids.size() are written.
+ * */
+inline std::size_t FindAll(std::string_view buffer, std::span<ULID> ulids) {
+	return FindAll(buffer, [&ulids, i = std::size_t{0}](ULID ulid, std::size_t) mutable {
+		if (i < ulids.size()) {
+			ulids[i++] = ulid;
+		}
+	});
+}
+
 /**
  * UnmarshalBinaryFrom will unmarshal a ULID from the passed byte array.
  * */
@@ -644,6 +1040,21 @@ inline ULID UnmarshalBinary(const boost::uuids::uuid& uuid) {
 	return ulid;
 }
 
+/**
+ * UnmarshalUuids will unmarshal every UUID of the passed span to a ULID in
+ * the passed span of the same size. A UUIDv7 keeps its timestamp as the
+ * ULID's Time.
+ * */
+inline void UnmarshalUuids(std::span<const boost::uuids::uuid> uuids, std::span<ULID> ulids) {
+	if (uuids.size() != ulids.size()) {
+		throw std::runtime_error("UnmarshalUuids spans must be of the same size");
+	}
+
+	for (std::size_t i = 0; i < uuids.size(); i++) {
+		UnmarshalBinaryFrom(uuids[i], ulids[i]);
+	}
+}
+
 /**
  * CompareULIDs will compare two ULIDs.
  * returns:
@@ -683,6 +1094,1369 @@ inline std::chrono::time_point<std::chrono::system_clock> Time(const ULID& ulid)
 	// NOLINTEND
 }
 
+/**
+ * BinaryView is a non-owning view of a ULID stored as 16 big-endian bytes,
+ * as written by MarshalBinaryTo, e.g. in memory mapped pages, network
+ * buffers or a boost::uuids::uuid.
+ *
+ * Comparison, Time, Hash and MarshalTo work on the bytes directly, without
+ * loading them into a ULID first. The viewed bytes must outlive the view.
+ * */
+class BinaryView {
+ public:
+	BinaryView() = default;
+
+	explicit BinaryView(std::span<const uint8_t, BIN_SIZE> bytes) : data_(bytes.data()) {}
+
+	explicit BinaryView(const boost::uuids::uuid& uuid) : data_(&*uuid.begin()) {}
+
+	const uint8_t* data() const { return data_; }
+
+	/**
+	 * Load will copy the viewed bytes into a ULID.
+	 * */
+	ULID Load() const {
+		ULID ulid = 0;
+		UnmarshalBinaryFrom(std::span<const uint8_t, BIN_SIZE>(data_, BIN_SIZE), ulid);
+		return ulid;
+	}
+
+	/**
+	 * Time:BinaryView = Time:ULID.
+	 * */
+	std::chrono::time_point<std::chrono::system_clock> Time() const {
+		// NOLINTBEGIN
+		int64_t ans = data_[0];
+
+		ans <<= 8;
+		ans |= data_[1];
+
+		ans <<= 8;
+		ans |= data_[2];
+
+		ans <<= 8;
+		ans |= data_[3];
+
+		ans <<= 8;
+		ans |= data_[4];
+
+		ans <<= 8;
+		ans |= data_[5];
+
+		return std::chrono::time_point<std::chrono::system_clock>(std::chrono::milliseconds{ans});
+		// NOLINTEND
+	}
+
+	/**
+	 * Hash will mix the viewed bytes into a hash value. It is not stable
+	 * across platforms of different endianness.
+	 * */
+	std::size_t Hash() const {
+		// NOLINTBEGIN
+		uint64_t hi = 0;
+		uint64_t lo = 0;
+		std::memcpy(&hi, data_, sizeof(hi));
+		std::memcpy(&lo, data_ + sizeof(hi), sizeof(lo));
+
+		uint64_t h = hi ^ (lo * 0x9E3779B97F4A7C15ULL);
+		h ^= h >> 33;
+		h *= 0xFF51AFD7ED558CCDULL;
+		h ^= h >> 33;
+		return static_cast<std::size_t>(h);
+		// NOLINTEND
+	}
+
+	// big-endian bytes compare the same way as the ULIDs they encode
+	friend bool operator==(const BinaryView& a, const BinaryView& b) {
+		return std::memcmp(a.data_, b.data_, BIN_SIZE) == 0;
+	}
+
+	friend std::strong_ordering operator<=>(const BinaryView& a, const BinaryView& b) {
+		return std::memcmp(a.data_, b.data_, BIN_SIZE) <=> 0;
+	}
+
+ private:
+	const uint8_t* data_ = nullptr;
+};
+
+/**
+ * MarshalTo:BinaryView = MarshalTo:ULID, following the same layout on the
+ * viewed bytes.
+ * */
+inline void MarshalTo(const BinaryView& view, std::span<char, STR_SIZE> dst) {
+	// NOLINTBEGIN
+	const uint8_t* data = view.data();
+
+	// 10 byte timestamp
+	dst[0] = Encoding[(data[0] & 224) >> 5];
+	dst[1] = Encoding[data[0] & 31];
+	dst[2] = Encoding[(data[1] & 248) >> 3];
+	dst[3] = Encoding[((data[1] & 7) << 2) | ((data[2] & 192) >> 6)];
+	dst[4] = Encoding[(data[2] & 62) >> 1];
+	dst[5] = Encoding[((data[2] & 1) << 4) | ((data[3] & 240) >> 4)];
+	dst[6] = Encoding[((data[3] & 15) << 1) | ((data[4] & 128) >> 7)];
+	dst[7] = Encoding[(data[4] & 124) >> 2];
+	dst[8] = Encoding[((data[4] & 3) << 3) | ((data[5] & 224) >> 5)];
+	dst[9] = Encoding[data[5] & 31];
+
+	// 16 bytes of entropy
+	dst[10] = Encoding[(data[6] & 248) >> 3];
+	dst[11] = Encoding[((data[6] & 7) << 2) | ((data[7] & 192) >> 6)];
+	dst[12] = Encoding[(data[7] & 62) >> 1];
+	dst[13] = Encoding[((data[7] & 1) << 4) | ((data[8] & 240) >> 4)];
+	dst[14] = Encoding[((data[8] & 15) << 1) | ((data[9] & 128) >> 7)];
+	dst[15] = Encoding[(data[9] & 124) >> 2];
+	dst[16] = Encoding[((data[9] & 3) << 3) | ((data[10] & 224) >> 5)];
+	dst[17] = Encoding[data[10] & 31];
+	dst[18] = Encoding[(data[11] & 248) >> 3];
+	dst[19] = Encoding[((data[11] & 7) << 2) | ((data[12] & 192) >> 6)];
+	dst[20] = Encoding[(data[12] & 62) >> 1];
+	dst[21] = Encoding[((data[12] & 1) << 4) | ((data[13] & 240) >> 4)];
+	dst[22] = Encoding[((data[13] & 15) << 1) | ((data[14] & 128) >> 7)];
+	dst[23] = Encoding[(data[14] & 124) >> 2];
+	dst[24] = Encoding[((data[14] & 3) << 3) | ((data[15] & 224) >> 5)];
+	dst[25] = Encoding[data[15] & 31];
+	// NOLINTEND
+}
+
+/**
+ * Marshal:BinaryView = Marshal:ULID.
+ * */
+inline std::string Marshal(const BinaryView& view) {
+	std::array<char, STR_SIZE> data{};
+	MarshalTo(view, data);
+	return std::string(data.data(), STR_SIZE);
+}
+
+/**
+ * StridedView is a random access range of BinaryViews over an array of
+ * fixed size records, each holding a binary ULID at the same offset.
+ *
+ * It can be searched in place, e.g. with std::ranges::lower_bound, without
+ * loading any ULID. See MutableStridedView to sort the records in place.
+ * */
+class StridedView {
+ public:
+	class Iterator {
+	 public:
+		using iterator_concept	= std::random_access_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type				= BinaryView;
+		using difference_type		= std::ptrdiff_t;
+		using reference					= BinaryView;
+
+		Iterator() = default;
+
+		Iterator(const uint8_t* data, std::size_t stride) : data_(data), stride_(stride) {}
+
+		BinaryView operator*() const {
+			return BinaryView(std::span<const uint8_t, BIN_SIZE>(data_, BIN_SIZE));
+		}
+
+		BinaryView operator[](difference_type n) const { return *(*this + n); }
+
+		Iterator& operator++() {
+			data_ += stride_;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator it = *this;
+			++*this;
+			return it;
+		}
+
+		Iterator& operator--() {
+			data_ -= stride_;
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			Iterator it = *this;
+			--*this;
+			return it;
+		}
+
+		Iterator& operator+=(difference_type n) {
+			data_ += n * static_cast<difference_type>(stride_);
+			return *this;
+		}
+
+		Iterator& operator-=(difference_type n) { return *this += -n; }
+
+		friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+
+		friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+
+		friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+		friend difference_type operator-(const Iterator& a, const Iterator& b) {
+			return (a.data_ - b.data_) / static_cast<difference_type>(a.stride_);
+		}
+
+		friend bool operator==(const Iterator& a, const Iterator& b) { return a.data_ == b.data_; }
+
+		friend std::strong_ordering operator<=>(const Iterator& a, const Iterator& b) {
+			return a.data_ <=> b.data_;
+		}
+
+	 private:
+		const uint8_t* data_ = nullptr;
+		std::size_t stride_	 = BIN_SIZE;
+	};
+
+	/**
+	 * StridedView will view every complete record of size stride in bytes,
+	 * with the ULID starting offset bytes into each record.
+	 * */
+	StridedView(std::span<const uint8_t> bytes, std::size_t stride, std::size_t offset = 0)
+			: stride_(stride) {
+		if (offset > stride || stride - offset < BIN_SIZE) {
+			throw std::runtime_error("StridedView records must hold a ULID at the offset");
+		}
+
+		size_ = bytes.size() / stride;
+		data_ = size_ == 0 ? nullptr : bytes.data() + offset;
+	}
+
+	std::size_t size() const { return size_; }
+
+	Iterator begin() const { return Iterator(data_, stride_); }
+
+	Iterator end() const { return begin() + static_cast<std::ptrdiff_t>(size_); }
+
+	BinaryView operator[](std::size_t i) const { return begin()[static_cast<std::ptrdiff_t>(i)]; }
+
+ private:
+	const uint8_t* data_ = nullptr;
+	std::size_t stride_;
+	std::size_t size_ = 0;
+};
+
+/**
+ * MutableStridedView is a random access range over an array of fixed size
+ * records, each holding a binary ULID at the same offset, that can be sorted
+ * in place, e.g. with std::ranges::sort.
+ *
+ * Dereferencing yields a Reference to the whole record, which compares by
+ * its ULID and copies or swaps all stride bytes on assignment, so sorting
+ * reorders complete records. Moving a record out, e.g. into a Record, copies
+ * its bytes.
+ * */
+class MutableStridedView {
+ public:
+	class Reference;
+
+	/**
+	 * Record is an owning copy of a record, the value type of the view.
+	 * */
+	class Record {
+	 public:
+		Record() = default;
+
+		Record(const Reference& reference);	 // NOLINT(google-explicit-constructor)
+
+		std::span<const uint8_t> bytes() const { return bytes_; }
+
+		BinaryView View() const {
+			return BinaryView(std::span<const uint8_t, BIN_SIZE>(bytes_.data() + offset_, BIN_SIZE));
+		}
+
+		friend bool operator==(const Record& a, const Record& b) { return a.View() == b.View(); }
+
+		friend std::strong_ordering operator<=>(const Record& a, const Record& b) {
+			return a.View() <=> b.View();
+		}
+
+	 private:
+		std::vector<uint8_t> bytes_;
+		std::size_t offset_ = 0;
+	};
+
+	/**
+	 * Reference is a proxy for a record in the viewed bytes. Assigning to it
+	 * overwrites the record.
+	 * */
+	class Reference {
+	 public:
+		Reference(uint8_t* record, std::size_t stride, std::size_t offset)
+				: record_(record), stride_(stride), offset_(offset) {}
+
+		Reference(const Reference&) = default;
+
+		const Reference& operator=(const Reference& other) const {
+			std::memmove(record_, other.record_, stride_);
+			return *this;
+		}
+
+		// NOLINTNEXTLINE(cppcoreguidelines-c-copy-assignment-signature)
+		const Reference& operator=(const Record& record) const {
+			std::memcpy(record_, record.bytes().data(), stride_);
+			return *this;
+		}
+
+		std::span<uint8_t> bytes() const { return {record_, stride_}; }
+
+		BinaryView View() const {
+			return BinaryView(std::span<const uint8_t, BIN_SIZE>(record_ + offset_, BIN_SIZE));
+		}
+
+		friend void swap(const Reference& a, const Reference& b) {
+			std::swap_ranges(a.record_, a.record_ + a.stride_, b.record_);
+		}
+
+		friend bool operator==(const Reference& a, const Reference& b) { return a.View() == b.View(); }
+
+		friend std::strong_ordering operator<=>(const Reference& a, const Reference& b) {
+			return a.View() <=> b.View();
+		}
+
+		friend bool operator==(const Reference& a, const Record& b) { return a.View() == b.View(); }
+
+		friend std::strong_ordering operator<=>(const Reference& a, const Record& b) {
+			return a.View() <=> b.View();
+		}
+
+	 private:
+		friend class Record;
+
+		uint8_t* record_;
+		std::size_t stride_;
+		std::size_t offset_;
+	};
+
+	class Iterator {
+	 public:
+		using iterator_concept	= std::random_access_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type				= Record;
+		using difference_type		= std::ptrdiff_t;
+		using reference					= Reference;
+
+		Iterator() = default;
+
+		Iterator(uint8_t* record, std::size_t stride, std::size_t offset)
+				: record_(record), stride_(stride), offset_(offset) {}
+
+		Reference operator*() const { return Reference(record_, stride_, offset_); }
+
+		Reference operator[](difference_type n) const { return *(*this + n); }
+
+		Iterator& operator++() {
+			record_ += stride_;
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator it = *this;
+			++*this;
+			return it;
+		}
+
+		Iterator& operator--() {
+			record_ -= stride_;
+			return *this;
+		}
+
+		Iterator operator--(int) {
+			Iterator it = *this;
+			--*this;
+			return it;
+		}
+
+		Iterator& operator+=(difference_type n) {
+			record_ += n * static_cast<difference_type>(stride_);
+			return *this;
+		}
+
+		Iterator& operator-=(difference_type n) { return *this += -n; }
+
+		friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+
+		friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+
+		friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+
+		friend difference_type operator-(const Iterator& a, const Iterator& b) {
+			return (a.record_ - b.record_) / static_cast<difference_type>(a.stride_);
+		}
+
+		friend bool operator==(const Iterator& a, const Iterator& b) { return a.record_ == b.record_; }
+
+		friend std::strong_ordering operator<=>(const Iterator& a, const Iterator& b) {
+			return a.record_ <=> b.record_;
+		}
+
+		friend Record iter_move(const Iterator& it) { return Record(*it); }
+
+		friend void iter_swap(const Iterator& a, const Iterator& b) { swap(*a, *b); }
+
+	 private:
+		uint8_t* record_		= nullptr;
+		std::size_t stride_ = BIN_SIZE;
+		std::size_t offset_ = 0;
+	};
+
+	/**
+	 * MutableStridedView will view every complete record of size stride in
+	 * bytes, with the ULID starting offset bytes into each record.
+	 * */
+	MutableStridedView(std::span<uint8_t> bytes, std::size_t stride, std::size_t offset = 0)
+			: stride_(stride), offset_(offset) {
+		if (offset > stride || stride - offset < BIN_SIZE) {
+			throw std::runtime_error("MutableStridedView records must hold a ULID at the offset");
+		}
+
+		size_ = bytes.size() / stride;
+		data_ = size_ == 0 ? nullptr : bytes.data();
+	}
+
+	std::size_t size() const { return size_; }
+
+	Iterator begin() const { return Iterator(data_, stride_, offset_); }
+
+	Iterator end() const { return begin() + static_cast<std::ptrdiff_t>(size_); }
+
+	Reference operator[](std::size_t i) const { return begin()[static_cast<std::ptrdiff_t>(i)]; }
+
+ private:
+	uint8_t* data_ = nullptr;
+	std::size_t stride_;
+	std::size_t offset_;
+	std::size_t size_ = 0;
+};
+
+inline MutableStridedView::Record::Record(const Reference& reference)
+		: bytes_(reference.record_, reference.record_ + reference.stride_), offset_(reference.offset_) {}
+
+/**
+ * MinForTime will create the smallest ULID for the millisecond of the passed
+ * time point, that is, the time point encoded with an all-zero entropy.
+ * */
+inline ULID MinForTime(std::chrono::time_point<std::chrono::system_clock> time_point) {
+	ULID ulid = 0;
+	EncodeTime(time_point, ulid);
+	return ulid;
+}
+
+/**
+ * MaxForTime will create the largest ULID for the millisecond of the passed
+ * time point, that is, the time point encoded with an all-ones entropy.
+ * */
+inline ULID MaxForTime(std::chrono::time_point<std::chrono::system_clock> time_point) {
+	// NOLINTBEGIN
+	ULID ulid = 1;
+	ulid <<= 80;
+	ulid--;
+	// NOLINTEND
+
+	EncodeTime(time_point, ulid);
+	return ulid;
+}
+
+/**
+ * MinStringForTime:MinForTime = Marshal:MarshalTo.
+ *
+ * Since the string form sorts the same way as the binary form, the result can
+ * be used as an inclusive lower bound for range scans over string keys.
+ * */
+inline std::string MinStringForTime(std::chrono::time_point<std::chrono::system_clock> time_point) {
+	return Marshal(MinForTime(time_point));
+}
+
+/**
+ * MaxStringForTime:MaxForTime = Marshal:MarshalTo.
+ *
+ * The result can be used as an inclusive upper bound for range scans over
+ * string keys.
+ * */
+inline std::string MaxStringForTime(std::chrono::time_point<std::chrono::system_clock> time_point) {
+	return Marshal(MaxForTime(time_point));
+}
+
+/**
+ * InterpolationLowerBound will return the index of the first ULID in the
+ * sorted span that is not less than the passed ULID.
+ *
+ * The probe position is interpolated from the top 64 bits (the timestamp and
+ * leading entropy) at both ends of the bracket holding the ULID, then the
+ * bracket is narrowed around it by stepping sqrt(width) away, doubling the
+ * step until the ULID is bounded on both sides. For roughly uniform
+ * timestamps the first step already bounds it, so each round shrinks the
+ * bracket to about its square root in 2 probes, which is O(log log n) probes
+ * overall. A round that fails to halve the bracket falls back to
+ * std::lower_bound, so skewed inputs still take O(log n) probes.
+ * */
+inline std::size_t InterpolationLowerBound(std::span<const ULID> ulids, const ULID& ulid) {
+	// NOLINTBEGIN
+	if (ulids.empty() || ulids.front() >= ulid) {
+		return 0;
+	}
+	if (ulids.back() < ulid) {
+		return ulids.size();
+	}
+
+	const uint64_t key = static_cast<uint64_t>(ulid >> 64);
+
+	// ulids[lo] < ulid <= ulids[hi] holds throughout, with their top 64 bits
+	// kept alongside so that no round probes its bounds again
+	std::size_t lo	= 0;
+	std::size_t hi	= ulids.size() - 1;
+	uint64_t lo_key = static_cast<uint64_t>(ulids[lo] >> 64);
+	uint64_t hi_key = static_cast<uint64_t>(ulids[hi] >> 64);
+
+	while (hi - lo > 32) {
+		const std::size_t width = hi - lo;
+
+		// lo_key <= key <= hi_key, so the fraction is in [0, 1]
+		std::size_t pos = lo + width / 2;
+		if (hi_key > lo_key) {
+			const double fraction =
+					static_cast<double>(key - lo_key) / static_cast<double>(hi_key - lo_key);
+			pos = lo + static_cast<std::size_t>(fraction * static_cast<double>(width));
+		}
+		pos = std::clamp(pos, lo + 1, hi - 1);
+
+		std::size_t step =
+				std::max<std::size_t>(1, static_cast<std::size_t>(std::sqrt(static_cast<double>(width))));
+		if (ulids[pos] < ulid) {
+			lo			= pos;
+			lo_key	= static_cast<uint64_t>(ulids[lo] >> 64);
+			while (hi - lo > step) {
+				if (ulids[lo + step] >= ulid) {
+					hi		 = lo + step;
+					hi_key = static_cast<uint64_t>(ulids[hi] >> 64);
+					break;
+				}
+				lo += step;
+				lo_key = static_cast<uint64_t>(ulids[lo] >> 64);
+				step *= 2;
+			}
+		} else {
+			hi		 = pos;
+			hi_key = static_cast<uint64_t>(ulids[hi] >> 64);
+			while (hi - lo > step) {
+				if (ulids[hi - step] < ulid) {
+					lo		 = hi - step;
+					lo_key = static_cast<uint64_t>(ulids[lo] >> 64);
+					break;
+				}
+				hi -= step;
+				hi_key = static_cast<uint64_t>(ulids[hi] >> 64);
+				step *= 2;
+			}
+		}
+
+		if (hi - lo > width / 2) {
+			break;
+		}
+	}
+
+	return static_cast<std::size_t>(
+			std::lower_bound(ulids.begin() + static_cast<std::ptrdiff_t>(lo + 1),
+											 ulids.begin() + static_cast<std::ptrdiff_t>(hi), ulid) -
+			ulids.begin());
+	// NOLINTEND
+}
+
+/**
+ * FindTimeRange will return the sub span of the sorted span holding every
+ * ULID whose timestamp falls in the milliseconds [from, to], both inclusive.
+ *
+ * The bounds are found using InterpolationLowerBound.
+ * */
+inline std::span<const ULID> FindTimeRange(
+		std::span<const ULID> ulids, std::chrono::time_point<std::chrono::system_clock> from,
+		std::chrono::time_point<std::chrono::system_clock> to) {
+	const std::size_t first = InterpolationLowerBound(ulids, MinForTime(from));
+	const ULID upper				= MaxForTime(to);
+
+	std::size_t last = first;
+	if (upper == ~static_cast<ULID>(0)) {
+		last = ulids.size();
+	} else if (from <= to) {
+		last = std::max(first, InterpolationLowerBound(ulids, upper + 1));
+	}
+
+	return ulids.subspan(first, last - first);
+}
+
+/**
+ * LoserTree will merge k sorted ULID sources into one sorted stream.
+ *
+ * A source is a callable bool(ULID&) that writes its next ULID and returns
+ * true, or returns false once exhausted. Each output ULID costs log2(k)
+ * comparisons of the __uint128_t keys along a single leaf to root path. Ties
+ * are broken by source index, so the merge is stable. With dedupe set,
+ * identical ULIDs are emitted only once, including across batches.
+ *
+ * Every node holds its loser's key next to a rank, which is the source index
+ * for live sources and k plus the index for exhausted ones, whose key is the
+ * largest ULID. Exhausted sources thus sort after every live one without a
+ * separate check in the comparison.
+ * */
+template <typename Source>
+	requires std::invocable<Source&, ULID&>
+class LoserTree {
+ public:
+	explicit LoserTree(std::vector<Source> sources, bool dedupe = false)
+			: sources_(std::move(sources)),
+				k_(static_cast<uint32_t>(sources_.size())),
+				nodes_(std::max<std::size_t>(sources_.size(), 1)),
+				dedupe_(dedupe) {
+		std::vector<Node> leaves(k_);
+		for (uint32_t i = 0; i < k_; i++) {
+			leaves[i] = Pull(i);
+		}
+		if (k_ == 0) {
+			nodes_[0] = Node{~static_cast<ULID>(0), 0};
+			return;
+		}
+		if (k_ == 1) {
+			nodes_[0] = leaves[0];
+			return;
+		}
+
+		// leaf i lives at node k + i, internal nodes are 1 .. k - 1
+		std::vector<Node> winners(2 * static_cast<std::size_t>(k_));
+		std::copy(leaves.begin(), leaves.end(), winners.begin() + k_);
+		for (std::size_t node = k_ - 1; node >= 1; node--) {
+			const Node& left	= winners[2 * node];
+			const Node& right = winners[2 * node + 1];
+			if (Less(left, right)) {
+				winners[node] = left;
+				nodes_[node]	= right;
+			} else {
+				winners[node] = right;
+				nodes_[node]	= left;
+			}
+		}
+		nodes_[0] = winners[1];
+	}
+
+	/**
+	 * Next will write the next batch of merged ULIDs to the passed span and
+	 * return how many were written, which is less than out.size() only once
+	 * every source is exhausted.
+	 * */
+	std::size_t Next(std::span<ULID> out) {
+		std::size_t n = 0;
+		while (n < out.size()) {
+			Node winner = nodes_[0];
+			if (winner.rank >= k_) {
+				break;
+			}
+
+			if (!dedupe_ || !has_last_ || winner.key != last_) {
+				out[n++] = winner.key;
+			}
+			last_			= winner.key;
+			has_last_ = true;
+
+			winner = Pull(winner.rank);
+			for (std::size_t node = (k_ + SourceIndex(winner)) / 2; node >= 1; node /= 2) {
+				// swapped with masks rather than a branch, the outcome of comparing
+				// random keys cannot be predicted
+				Node& loser				= nodes_[node];
+				const bool swap		= Less(loser, winner);
+				const ULID key		= (loser.key ^ winner.key) & -static_cast<ULID>(swap);
+				const uint32_t rank = (loser.rank ^ winner.rank) & -static_cast<uint32_t>(swap);
+				loser.key ^= key;
+				winner.key ^= key;
+				loser.rank ^= rank;
+				winner.rank ^= rank;
+			}
+			nodes_[0] = winner;
+		}
+		return n;
+	}
+
+ private:
+	struct Node {
+		ULID key;
+		uint32_t rank;
+	};
+
+	static bool Less(const Node& a, const Node& b) {
+		return (a.key < b.key) | ((a.key == b.key) & (a.rank < b.rank));
+	}
+
+	uint32_t SourceIndex(const Node& node) const { return node.rank >= k_ ? node.rank - k_ : node.rank; }
+
+	Node Pull(uint32_t source) {
+		Node node{0, source};
+		if (!sources_[source](node.key)) {
+			node = Node{~static_cast<ULID>(0), k_ + source};
+		}
+		return node;
+	}
+
+	std::vector<Source> sources_;
+	uint32_t k_;
+	std::vector<Node> nodes_;	 // nodes_[0] is the winner, the rest are losers
+	bool dedupe_;
+	bool has_last_ = false;
+	ULID last_		 = 0;
+};
+
+/**
+ * MergeK will merge the passed sorted spans into out using a LoserTree and
+ * return the number of ULIDs written. out should be able to hold the sum of
+ * the input sizes, otherwise the merge stops once it is full.
+ * */
+inline std::size_t MergeK(std::span<const std::span<const ULID>> inputs, std::span<ULID> out,
+													bool dedupe = false) {
+	auto cursor = [](std::span<const ULID> input) {
+		return [input, i = std::size_t{0}](ULID& ulid) mutable {
+			if (i == input.size()) {
+				return false;
+			}
+			ulid = input[i++];
+			return true;
+		};
+	};
+
+	std::vector<decltype(cursor(std::span<const ULID>{}))> sources;
+	sources.reserve(inputs.size());
+	for (const std::span<const ULID>& input : inputs) {
+		sources.push_back(cursor(input));
+	}
+
+	LoserTree tree(std::move(sources), dedupe);
+	return tree.Next(out);
+}
+
+/**
+ * StringGenerator will create ULIDs directly in their string form.
+ *
+ * The encoded timestamp is cached for the current millisecond, so only the
+ * entropy is encoded per ULID. In monotonic mode (the default) the entropy is
+ * sourced once per millisecond using RAND_bytes and every further ULID in the
+ * same millisecond (or while the clock is behind) is the previous one
+ * incremented in place on its Base32 characters, otherwise fresh entropy is
+ * encoded for every ULID.
+ *
+ * A StringGenerator is not thread-safe, use one per thread.
+ * */
+class StringGenerator {
+ public:
+	using Clock = std::function<std::chrono::time_point<std::chrono::system_clock>()>;
+
+	explicit StringGenerator(bool monotonic = true, Clock clock = std::chrono::system_clock::now)
+			: monotonic_(monotonic), clock_(std::move(clock)) {}
+
+	/**
+	 * NextTo will write the next ULID to the passed character array.
+	 * */
+	void NextTo(std::span<char, STR_SIZE> dst) {
+		const int64_t ms = std::chrono::time_point_cast<std::chrono::milliseconds>(clock_())
+													 .time_since_epoch()
+													 .count();
+
+		if (!has_last_ || ms > last_ms_) {
+			ULID ulid = 0;
+			EncodeTime(std::chrono::time_point<std::chrono::system_clock>(std::chrono::milliseconds{ms}),
+								 ulid);
+			MarshalTo(ulid, last_);
+			EncodeEntropyTo(std::span<char, STR_SIZE - 10>(last_.data() + 10, STR_SIZE - 10));	// NOLINT
+			last_ms_	= ms;
+			has_last_ = true;
+		} else if (monotonic_) {
+			Increment();
+		} else {
+			EncodeEntropyTo(std::span<char, STR_SIZE - 10>(last_.data() + 10, STR_SIZE - 10));	// NOLINT
+		}
+
+		std::copy(last_.begin(), last_.end(), dst.begin());
+	}
+
+	/**
+	 * Next:NextTo = Marshal:MarshalTo.
+	 * */
+	std::string Next() {
+		std::array<char, STR_SIZE> data{};
+		NextTo(data);
+		return std::string(data.data(), STR_SIZE);
+	}
+
+ private:
+	// EncodeEntropyTo will encode 80 random bits as 16 Base32 characters
+	static void EncodeEntropyTo(std::span<char, STR_SIZE - 10> dst) {	// NOLINT
+		// NOLINTBEGIN
+		uint8_t buffer[10];
+
+		if (RAND_bytes(buffer, sizeof(buffer)) != 1) {
+			throw std::runtime_error("Failed to generate random bytes with OpenSSL");
+		}
+
+		// every 5 bytes encode to 8 characters
+		for (int group = 0; group < 2; group++) {
+			uint64_t bits = 0;
+			for (int i = 0; i < 5; i++) {
+				bits = (bits << 8) | buffer[group * 5 + i];
+			}
+			for (int i = 7; i >= 0; i--) {
+				dst[group * 8 + i] = Encoding[bits & 31];
+				bits >>= 5;
+			}
+		}
+		// NOLINTEND
+	}
+
+	// Increment will add one to the entropy characters of the last ULID
+	void Increment() {
+		// NOLINTBEGIN
+		for (int i = STR_SIZE - 1; i >= 10; i--) {
+			const uint8_t value = dec[static_cast<uint8_t>(last_[i])];
+			if (value < 31) {
+				last_[i] = Encoding[value + 1];
+				return;
+			}
+			last_[i] = Encoding[0];
+		}
+
+		std::fill(last_.begin() + 10, last_.end(), Encoding[31]);
+		throw std::runtime_error("ULID entropy overflow");
+		// NOLINTEND
+	}
+
+	bool monotonic_;
+	Clock clock_;
+	bool has_last_	 = false;
+	int64_t last_ms_ = 0;
+	std::array<char, STR_SIZE> last_{};
+};
+
+/**
+ * DistinctCounter is a HyperLogLog++ sketch estimating the number of distinct
+ * ULIDs added to it.
+ *
+ * The 80 bits of entropy are used as the hash directly, so the ULIDs must
+ * carry random entropy (ULIDs incremented within a millisecond by a monotonic
+ * generator share their leading entropy bits and are undercounted).
+ *
+ * Small cardinalities are kept in a sparse list of 25 bit register indices,
+ * estimated with linear counting, which is converted to 2^precision dense
+ * registers once it would use more memory than them. The empirical bias
+ * correction tables of HLL++ are not applied. Sketches of the same precision
+ * can be merged, e.g. across threads or nodes.
+ * */
+class DistinctCounter {
+ public:
+	explicit DistinctCounter(uint8_t precision = 14) : precision_(precision) {
+		if (precision < 4 || precision > 18) {	// NOLINT
+			throw std::runtime_error("DistinctCounter precision must be in [4, 18]");
+		}
+	}
+
+	uint8_t Precision() const { return precision_; }
+
+	bool IsSparse() const { return registers_.empty(); }
+
+	/**
+	 * Add will add the passed ULID to the sketch.
+	 * */
+	void Add(const ULID& ulid) {
+		if (!IsSparse()) {
+			AddDense(ulid);
+			return;
+		}
+
+		AddSparse(EncodeSparse(ulid));
+	}
+
+	/**
+	 * Add will add the passed batch of ULIDs to the sketch.
+	 * */
+	void Add(std::span<const ULID> ulids) {
+		for (const ULID& ulid : ulids) {
+			if (!IsSparse()) {
+				AddDense(ulid);
+				continue;
+			}
+			AddSparse(EncodeSparse(ulid));
+		}
+	}
+
+	/**
+	 * Merge will add every ULID added to the passed sketch to this one.
+	 * */
+	void Merge(const DistinctCounter& other) {
+		if (other.precision_ != precision_) {
+			throw std::runtime_error("Cannot merge DistinctCounters of different precision");
+		}
+		if (&other == this) {
+			return;
+		}
+
+		if (IsSparse() && other.IsSparse()) {
+			pending_.insert(pending_.end(), other.sparse_.begin(), other.sparse_.end());
+			pending_.insert(pending_.end(), other.pending_.begin(), other.pending_.end());
+			Flush();
+			return;
+		}
+
+		ToDense();
+		if (other.IsSparse()) {
+			for (uint32_t encoded : other.sparse_) {
+				AddDenseSparse(registers_, encoded);
+			}
+			for (uint32_t encoded : other.pending_) {
+				AddDenseSparse(registers_, encoded);
+			}
+			return;
+		}
+
+		for (std::size_t i = 0; i < registers_.size(); i++) {
+			registers_[i] = std::max(registers_[i], other.registers_[i]);
+		}
+	}
+
+	/**
+	 * Estimate will return the estimated number of distinct ULIDs added.
+	 *
+	 * Pending sparse entries are taken into account as if merged, so the
+	 * estimate only depends on the ULIDs added, not on how they were batched.
+	 * */
+	uint64_t Estimate() const {
+		if (!IsSparse()) {
+			return DenseEstimate(registers_);
+		}
+
+		std::vector<uint32_t> sparse	= sparse_;
+		std::vector<uint32_t> pending = pending_;
+		MergeSparse(sparse, pending);
+
+		if (sparse.size() > SparseLimit()) {
+			std::vector<uint8_t> registers(std::size_t{1} << precision_, 0);
+			for (uint32_t encoded : sparse) {
+				AddDenseSparse(registers, encoded);
+			}
+			return DenseEstimate(registers);
+		}
+
+		const double m = static_cast<double>(uint64_t{1} << kSparsePrecision);
+		return static_cast<uint64_t>(
+				std::llround(m * std::log(m / (m - static_cast<double>(sparse.size())))));
+	}
+
+ private:
+	static constexpr int kSparsePrecision		= 25;
+	static constexpr std::size_t kMaxPending = 1024;
+
+	// EncodeSparse will pack the top 25 entropy bits and the rank of the
+	// remaining 55 bits as index << 6 | rank
+	static uint32_t EncodeSparse(const ULID& ulid) {
+		// NOLINTBEGIN
+		const auto index = static_cast<uint32_t>(ulid >> 55) & ((1U << kSparsePrecision) - 1);
+		const uint64_t rest = static_cast<uint64_t>(ulid) << 9;	 // the remaining 55 bits, left aligned
+		const auto rank			= static_cast<uint32_t>(std::min(std::countl_zero(rest), 55) + 1);
+		return (index << 6) | rank;
+		// NOLINTEND
+	}
+
+	static uint64_t DenseEstimate(const std::vector<uint8_t>& registers) {
+		const auto m = static_cast<double>(registers.size());
+
+		double sum				= 0;
+		std::size_t zeros = 0;
+		for (uint8_t value : registers) {
+			sum += std::ldexp(1.0, -value);
+			zeros += value == 0;
+		}
+
+		// NOLINTBEGIN
+		double alpha = 0.7213 / (1 + 1.079 / m);
+		if (registers.size() == 16) {
+			alpha = 0.673;
+		} else if (registers.size() == 32) {
+			alpha = 0.697;
+		} else if (registers.size() == 64) {
+			alpha = 0.709;
+		}
+
+		double estimate = alpha * m * m / sum;
+		if (estimate <= 2.5 * m && zeros > 0) {
+			estimate = m * std::log(m / static_cast<double>(zeros));
+		}
+		// NOLINTEND
+
+		return static_cast<uint64_t>(std::llround(estimate));
+	}
+
+	// MergeSparse will sort the passed entries and merge them linearly into the
+	// sorted sparse list, keeping the highest rank per index
+	static void MergeSparse(std::vector<uint32_t>& sparse, std::vector<uint32_t>& pending) {
+		if (pending.empty()) {
+			return;
+		}
+
+		std::sort(pending.begin(), pending.end());
+
+		std::vector<uint32_t> merged;
+		merged.reserve(sparse.size() + pending.size());
+		std::merge(sparse.begin(), sparse.end(), pending.begin(), pending.end(),
+							 std::back_inserter(merged));
+
+		// entries of one index sort by rank, keep the last
+		std::size_t n = 0;
+		for (std::size_t i = 0; i < merged.size(); i++) {
+			if (i + 1 < merged.size() && merged[i] >> 6 == merged[i + 1] >> 6) {	// NOLINT
+				continue;
+			}
+			merged[n++] = merged[i];
+		}
+		merged.resize(n);
+		sparse.swap(merged);
+	}
+
+	// SparseLimit is the number of sparse entries using as much memory as the
+	// dense registers
+	std::size_t SparseLimit() const { return (std::size_t{1} << precision_) / sizeof(uint32_t); }
+
+	// AddSparse will queue the passed entry, merging the queue once it holds
+	// min(kMaxPending, SparseLimit()) entries
+	void AddSparse(uint32_t encoded) {
+		pending_.push_back(encoded);
+		if (pending_.size() >= std::min(kMaxPending, SparseLimit())) {
+			Flush();
+		}
+	}
+
+	void Flush() {
+		MergeSparse(sparse_, pending_);
+		pending_.clear();
+
+		if (sparse_.size() > SparseLimit()) {
+			ToDense();
+		}
+	}
+
+	void ToDense() {
+		if (!IsSparse()) {
+			return;
+		}
+
+		registers_.assign(std::size_t{1} << precision_, 0);
+		for (uint32_t encoded : sparse_) {
+			AddDenseSparse(registers_, encoded);
+		}
+		for (uint32_t encoded : pending_) {
+			AddDenseSparse(registers_, encoded);
+		}
+		sparse_	= std::vector<uint32_t>();
+		pending_ = std::vector<uint32_t>();
+	}
+
+	void AddDense(const ULID& ulid) {
+		// NOLINTBEGIN
+		const int width = 80 - precision_;
+		const auto index = static_cast<std::size_t>(ulid >> width) & ((std::size_t{1} << precision_) - 1);
+
+		const ULID rest		= ulid & ((static_cast<ULID>(1) << width) - 1);
+		const auto hi			= static_cast<uint64_t>(rest >> 64);
+		const int bits		= hi != 0 ? 64 + std::bit_width(hi) : std::bit_width(static_cast<uint64_t>(rest));
+		const auto rank		= static_cast<uint8_t>(width - bits + 1);
+		registers_[index] = std::max(registers_[index], rank);
+		// NOLINTEND
+	}
+
+	void AddDenseSparse(std::vector<uint8_t>& registers, uint32_t encoded) const {
+		// NOLINTBEGIN
+		const int shift			 = kSparsePrecision - precision_;
+		const uint32_t index = encoded >> 6;
+		const uint32_t low	 = index & ((1U << shift) - 1);
+
+		const auto rank = static_cast<uint8_t>(low != 0 ? shift - std::bit_width(low) + 1
+																										: shift + static_cast<int>(encoded & 63));
+
+		uint8_t& value = registers[index >> shift];
+		value					 = std::max(value, rank);
+		// NOLINTEND
+	}
+
+	uint8_t precision_;
+	std::vector<uint32_t> sparse_;	 // sorted, one entry per index
+	std::vector<uint32_t> pending_;	 // unsorted, not yet merged into sparse_
+	std::vector<uint8_t> registers_;	// empty while sparse
+};
+
+/**
+ * WindowedDistinctCounter keeps one DistinctCounter per time window, keyed on
+ * the start of the window the ULID's Time falls into.
+ * */
+class WindowedDistinctCounter {
+ public:
+	using Windows = std::map<std::chrono::time_point<std::chrono::system_clock>, DistinctCounter>;
+
+	explicit WindowedDistinctCounter(std::chrono::milliseconds window, uint8_t precision = 14)
+			: window_(window), precision_(precision) {
+		if (window.count() <= 0) {
+			throw std::runtime_error("WindowedDistinctCounter window must be positive");
+		}
+	}
+
+	/**
+	 * Add will add the passed ULID to the sketch of its window.
+	 * */
+	void Add(const ULID& ulid) { Window(WindowStart(Time(ulid))).Add(ulid); }
+
+	/**
+	 * Add will add the passed batch of ULIDs, passing each run of ULIDs that
+	 * fall into the same window to its sketch at once.
+	 * */
+	void Add(std::span<const ULID> ulids) {
+		std::size_t first = 0;
+		while (first < ulids.size()) {
+			const auto start = WindowStart(Time(ulids[first]));
+
+			std::size_t last = first + 1;
+			while (last < ulids.size() && WindowStart(Time(ulids[last])) == start) {
+				last++;
+			}
+
+			Window(start).Add(ulids.subspan(first, last - first));
+			first = last;
+		}
+	}
+
+	/**
+	 * Merge will merge every window of the passed counter into this one.
+	 * */
+	void Merge(const WindowedDistinctCounter& other) {
+		if (other.window_ != window_) {
+			throw std::runtime_error("Cannot merge WindowedDistinctCounters of different windows");
+		}
+		for (const auto& [start, counter] : other.windows_) {
+			Window(start).Merge(counter);
+		}
+	}
+
+	/**
+	 * Estimate will return the estimated number of distinct ULIDs in the window
+	 * containing the passed time point.
+	 * */
+	uint64_t Estimate(std::chrono::time_point<std::chrono::system_clock> time_point) const {
+		auto it = windows_.find(WindowStart(time_point));
+		return it == windows_.end() ? 0 : it->second.Estimate();
+	}
+
+	const Windows& windows() const { return windows_; }
+
+ private:
+	std::chrono::time_point<std::chrono::system_clock> WindowStart(
+			std::chrono::time_point<std::chrono::system_clock> time_point) const {
+		return std::chrono::floor<std::chrono::milliseconds>(time_point) -
+					 (std::chrono::floor<std::chrono::milliseconds>(time_point).time_since_epoch() % window_);
+	}
+
+	DistinctCounter& Window(std::chrono::time_point<std::chrono::system_clock> start) {
+		return windows_.try_emplace(start, precision_).first->second;
+	}
+
+	std::chrono::milliseconds window_;
+	uint8_t precision_;
+	Windows windows_;
+};
+
+#if ULID_HAS_MMAP
+/**
+ * PersistentGenerator will create strictly increasing ULIDs whose ordering
+ * survives process restarts.
+ *
+ * A high-water mark is kept in a small memory mapped checkpoint file. Every
+ * ULID up to MaxForTime(t + reserve) is reserved ahead of time, and the file
+ * is only msync'ed when a ULID crosses the mark, i.e. once per reserve window
+ * rather than once per ULID. On destruction the last ULID is persisted as
+ * the mark instead.
+ *
+ * On startup generation resumes strictly above the persisted mark: the first
+ * ULID takes the later of the clock and the millisecond after the mark, with
+ * entropy sourced using EncodeEntropyRand. After a clean shutdown this is the
+ * millisecond after the last ULID, after a crash timestamps may run up to
+ * reserve ahead of the clock until it catches up.
+ *
+ * Afterwards, within a millisecond (or while the clock is behind the last
+ * ULID) the next ULID is the previous one incremented, otherwise the entropy
+ * is sourced using EncodeEntropyRand.
+ *
+ * The checkpoint file is locked while in use, so only one generator per
+ * file can exist at a time.
+ * */
+class PersistentGenerator {
+ public:
+	using Clock = std::function<std::chrono::time_point<std::chrono::system_clock>()>;
+
+	explicit PersistentGenerator(const std::string& path,
+															 std::chrono::milliseconds reserve = std::chrono::seconds(1),
+															 Clock clock = std::chrono::system_clock::now)
+			: reserve_(reserve), clock_(std::move(clock)) {
+		if (reserve.count() < 0) {
+			throw std::runtime_error("PersistentGenerator reserve must not be negative");
+		}
+
+		fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);	// NOLINT
+		if (fd_ < 0) {
+			throw std::runtime_error("Failed to open ULID checkpoint " + path);
+		}
+
+		if (::flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+			::close(fd_);
+			throw std::runtime_error("ULID checkpoint " + path + " is in use");
+		}
+
+		struct stat st {};
+		if (::fstat(fd_, &st) != 0 ||
+				(st.st_size == 0 && ::ftruncate(fd_, sizeof(Checkpoint)) != 0)) {
+			::close(fd_);
+			throw std::runtime_error("Failed to size ULID checkpoint " + path);
+		}
+
+		void* addr = ::mmap(nullptr, sizeof(Checkpoint), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+		if (addr == MAP_FAILED) {	// NOLINT
+			::close(fd_);
+			throw std::runtime_error("Failed to map ULID checkpoint " + path);
+		}
+		checkpoint_ = static_cast<Checkpoint*>(addr);
+
+		// a crash right after creating the file can leave it zero filled, which
+		// is as good as a fresh one since no ULID was issued from it yet
+		const bool fresh = st.st_size == 0 || (st.st_size == sizeof(Checkpoint) && checkpoint_->magic == 0 &&
+																					 checkpoint_->hi == 0 && checkpoint_->lo == 0);
+		if (fresh) {
+			checkpoint_->magic = kMagic;
+			if (::msync(checkpoint_, sizeof(Checkpoint), MS_SYNC) != 0) {
+				::munmap(checkpoint_, sizeof(Checkpoint));
+				::close(fd_);
+				throw std::runtime_error("Failed to sync ULID checkpoint " + path);
+			}
+		} else if (st.st_size != sizeof(Checkpoint) || checkpoint_->magic != kMagic) {
+			::munmap(checkpoint_, sizeof(Checkpoint));
+			::close(fd_);
+			throw std::runtime_error("Invalid ULID checkpoint " + path);
+		}
+
+		// NOLINTBEGIN
+		mark_ = checkpoint_->hi;
+		mark_ <<= 64;
+		mark_ |= checkpoint_->lo;
+		// NOLINTEND
+		last_ = mark_;
+	}
+
+	PersistentGenerator(const PersistentGenerator&)						 = delete;
+	PersistentGenerator& operator=(const PersistentGenerator&) = delete;
+
+	~PersistentGenerator() {
+		// no ULID above last_ was issued, so it is a tighter mark to resume from
+		Store(last_);
+		::msync(checkpoint_, sizeof(Checkpoint), MS_SYNC);
+		::munmap(checkpoint_, sizeof(Checkpoint));
+		::close(fd_);
+	}
+
+	/**
+	 * Next will create the next ULID, persisting a new high-water mark first
+	 * if the ULID lies beyond the current one.
+	 * */
+	ULID Next() {
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		ULID ulid = 0;
+		EncodeTime(clock_(), ulid);
+
+		// NOLINTBEGIN
+		if ((ulid >> 80) > (last_ >> 80)) {
+			EncodeEntropyRand(ulid);
+		} else if (resuming_) {
+			// incrementing the mark would start from predictable entropy
+			if ((last_ >> 80) == (~static_cast<ULID>(0) >> 80)) {
+				throw std::runtime_error("ULID space exhausted");
+			}
+			ulid = 0;
+			EncodeTime(Time(last_) + std::chrono::milliseconds(1), ulid);
+			EncodeEntropyRand(ulid);
+		} else {
+			if (last_ == ~static_cast<ULID>(0)) {
+				throw std::runtime_error("ULID space exhausted");
+			}
+			ulid = last_ + 1;
+		}
+		// NOLINTEND
+
+		if (ulid > mark_) {
+			Reserve(ulid);
+		}
+
+		last_			= ulid;
+		resuming_ = false;
+		return ulid;
+	}
+
+	/**
+	 * Mark will return the persisted high-water mark.
+	 * */
+	ULID Mark() {
+		std::lock_guard<std::mutex> lock(mutex_);
+		return mark_;
+	}
+
+ private:
+	static constexpr uint64_t kMagic = 0x554C49444D41524BULL;	 // "ULIDMARK"
+
+	struct Checkpoint {
+		uint64_t magic;
+		uint64_t hi;
+		uint64_t lo;
+	};
+
+	void Reserve(const ULID& ulid) {
+		const ULID mark = MaxForTime(Time(ulid) + reserve_);
+		Store(mark);
+
+		if (::msync(checkpoint_, sizeof(Checkpoint), MS_SYNC) != 0) {
+			throw std::runtime_error("Failed to sync ULID checkpoint");
+		}
+		mark_ = mark;
+	}
+
+	void Store(const ULID& mark) {
+		// NOLINTBEGIN
+		checkpoint_->hi = static_cast<uint64_t>(mark >> 64);
+		checkpoint_->lo = static_cast<uint64_t>(mark);
+		// NOLINTEND
+	}
+
+	std::chrono::milliseconds reserve_;
+	Clock clock_;
+	std::mutex mutex_;
+	int fd_									= -1;
+	Checkpoint* checkpoint_ = nullptr;
+	ULID last_							= 0;
+	ULID mark_							= 0;
+	bool resuming_					= true;
+};
+#endif
+
 };	// namespace ulid
 
+template <>
+struct std::hash<ulid::BinaryView> {
+	std::size_t operator()(const ulid::BinaryView& view) const { return view.Hash(); }
+};
+
+// records and references to them have records as their common reference, as
+// required by std::ranges algorithms over MutableStridedView
+template <template <class> class TQual, template <class> class UQual>
+struct std::basic_common_reference<ulid::MutableStridedView::Record,
+																	 ulid::MutableStridedView::Reference, TQual, UQual> {
+	using type = ulid::MutableStridedView::Record;
+};
+
+template <template <class> class TQual, template <class> class UQual>
+struct std::basic_common_reference<ulid::MutableStridedView::Reference,
+																	 ulid::MutableStridedView::Record, TQual, UQual> {
+	using type = ulid::MutableStridedView::Record;
+};
+
 #endif	// ULID_UINT128_HH
@@ -2,6 +2,8 @@
 #include <gtest/gtest.h>
 #include <chrono>
 #include <ctime>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 
 #include "ulid.h"
@@ -174,3 +176,713 @@ TEST(LexicographicalOrder, 1) {
 	EXPECT_EQ(-1, ulid::CompareULIDs(ulid1, ulid2));
 	EXPECT_EQ(1, ulid::CompareULIDs(ulid2, ulid1));
 }
+
+TEST(MinMaxForTime, 1) {
+	ulid::ULID min = ulid::MinForTime(ts);
+	ulid::ULID max = ulid::MaxForTime(ts);
+
+	ASSERT_EQ(ts, ulid::Time(min));
+	ASSERT_EQ(ts, ulid::Time(max));
+	ASSERT_EQ("01B6KZ5EZ00000000000000000", ulid::MinStringForTime(ts));
+	ASSERT_EQ("01B6KZ5EZ0ZZZZZZZZZZZZZZZZ", ulid::MaxStringForTime(ts));
+
+	ulid::ULID ulid = ulid::Create(ts, []() { return 4; });
+	ASSERT_EQ(-1, ulid::CompareULIDs(min, ulid));
+	ASSERT_EQ(1, ulid::CompareULIDs(max, ulid));
+	ASSERT_EQ(ulid::MaxForTime(ts) + 1, ulid::MinForTime(ts + std::chrono::milliseconds(1)));
+}
+
+TEST(FindTimeRange, 1) {
+	std::mt19937 generator(4);
+	std::uniform_int_distribution<int> offsets(0, 100000);
+
+	std::vector<ulid::ULID> ulids;
+	for (int i = 0; i < 20000; i++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts + std::chrono::milliseconds(offsets(generator)), ulid);
+		ulid::EncodeEntropyMt19937(generator, ulid);
+		ulids.push_back(ulid);
+	}
+	std::sort(ulids.begin(), ulids.end());
+
+	for (int i = 0; i < 200; i++) {
+		auto from = ts + std::chrono::milliseconds(offsets(generator) - 10);
+		auto to		= from + std::chrono::milliseconds(offsets(generator) % 500);
+
+		auto first = std::lower_bound(ulids.begin(), ulids.end(), ulid::MinForTime(from));
+		auto last	 = std::upper_bound(ulids.begin(), ulids.end(), ulid::MaxForTime(to));
+
+		std::span<const ulid::ULID> got = ulid::FindTimeRange(ulids, from, to);
+		ASSERT_EQ(first - ulids.begin(), got.data() - ulids.data());
+		ASSERT_EQ(last - first, got.size());
+	}
+
+	ASSERT_EQ(0, ulid::FindTimeRange(ulids, ts + std::chrono::milliseconds(5), ts).size());
+	ASSERT_EQ(0, ulid::FindTimeRange({}, ts, ts).size());
+}
+
+TEST(Philox4x32, 1) {
+	// Known answer from the Random123 test vectors.
+	ulid::Philox4x32 generator(0);
+	std::array<uint32_t, 4> block = generator(0);
+
+	ASSERT_EQ(0x6627e8d5, block[0]);
+	ASSERT_EQ(0xe169c58d, block[1]);
+	ASSERT_EQ(0xbc57ac4c, block[2]);
+	ASSERT_EQ(0x9b00dbd8, block[3]);
+}
+
+TEST(GenerateParallel, 1) {
+	auto timestamp_fn = [](std::size_t i) { return ts + std::chrono::milliseconds(i / 16); };
+
+	std::vector<ulid::ULID> expected(10007);
+	ulid::GenerateParallel(expected, 4, timestamp_fn, 1);
+
+	for (unsigned threads : {2U, 3U, 8U, 0U}) {
+		std::vector<ulid::ULID> got(expected.size());
+		ulid::GenerateParallel(got, 4, timestamp_fn, threads);
+		ASSERT_EQ(expected, got);
+	}
+
+	ulid::Philox4x32 generator(4);
+	ulid::ULID ulid = 0;
+	ulid::EncodeTime(timestamp_fn(5000), ulid);
+	ulid::EncodeEntropyPhilox(generator, 5000, ulid);
+	ASSERT_EQ(ulid, expected[5000]);
+	ASSERT_EQ(timestamp_fn(5000), ulid::Time(ulid));
+	ASSERT_NE(expected[0], expected[1]);
+}
+
+#if ULID_HAS_MMAP
+// CheckpointPath will return a temporary path unique to the running test and
+// process, so that tests can run in parallel.
+std::string CheckpointPath(const std::string& suffix = "") {
+	const auto* info = testing::UnitTest::GetInstance()->current_test_info();
+	return (std::filesystem::temp_directory_path() /
+					(std::string("ulid_") + info->test_suite_name() + "_" + info->name() + "_" +
+					 std::to_string(getpid()) + suffix))
+			.string();
+}
+
+TEST(PersistentGenerator, 1) {
+	const std::string path = CheckpointPath();
+	std::filesystem::remove(path);
+
+	auto now	 = ts;
+	auto clock = [&now]() { return now; };
+
+	ulid::ULID last = 0;
+	{
+		ulid::PersistentGenerator generator(path, std::chrono::seconds(1), clock);
+		ASSERT_THROW(ulid::PersistentGenerator(path, std::chrono::seconds(1), clock),
+								 std::runtime_error);
+
+		last = generator.Next();
+		const ulid::ULID mark = generator.Mark();
+		ASSERT_EQ(ulid::MaxForTime(ts + std::chrono::seconds(1)), mark);
+
+		for (int i = 0; i < 1000; i++) {
+			now += std::chrono::microseconds(100);
+			ulid::ULID ulid = generator.Next();
+			ASSERT_EQ(-1, ulid::CompareULIDs(last, ulid));
+			last = ulid;
+		}
+		ASSERT_EQ(mark, generator.Mark());
+
+		now += std::chrono::seconds(2);
+		last = generator.Next();
+		ASSERT_EQ(-1, ulid::CompareULIDs(mark, generator.Mark()));
+	}
+
+	// restart with a clock that went backwards, after a clean shutdown the
+	// generator resumes right after the last ULID with random entropy
+	now = ts;
+	ulid::PersistentGenerator generator(path, std::chrono::seconds(1), clock);
+	ulid::ULID ulid = generator.Next();
+	ASSERT_EQ(-1, ulid::CompareULIDs(last, ulid));
+	ASSERT_EQ(ulid::Time(last) + std::chrono::milliseconds(1), ulid::Time(ulid));
+	ASSERT_NE(ulid::MinForTime(ulid::Time(ulid)), ulid);
+	ASSERT_EQ(ulid + 1, generator.Next());
+
+	std::filesystem::remove(path);
+}
+
+TEST(PersistentGenerator, 2) {
+	const std::string path		= CheckpointPath();
+	const std::string crashed = CheckpointPath("_crashed");
+	std::filesystem::remove(path);
+	std::filesystem::remove(crashed);
+
+	auto clock = []() { return ts; };
+
+	ASSERT_THROW(ulid::PersistentGenerator(path, std::chrono::milliseconds(-1), clock),
+							 std::runtime_error);
+
+	ulid::ULID last = 0;
+	{
+		ulid::PersistentGenerator generator(path, std::chrono::seconds(1), clock);
+		last = generator.Next();
+
+		// a copy of the checkpoint while the generator runs is what a crash leaves
+		std::filesystem::copy_file(path, crashed);
+	}
+
+	ulid::PersistentGenerator generator(crashed, std::chrono::seconds(1), clock);
+	ulid::ULID ulid = generator.Next();
+	ASSERT_EQ(ts + std::chrono::seconds(1) + std::chrono::milliseconds(1), ulid::Time(ulid));
+	ASSERT_NE(ulid::MinForTime(ulid::Time(ulid)), ulid);
+	ASSERT_EQ(-1, ulid::CompareULIDs(last, ulid));
+
+	std::filesystem::remove(path);
+	std::filesystem::remove(crashed);
+}
+
+TEST(PersistentGenerator, 3) {
+	// a zero filled checkpoint, left by a crash right after creation, is fresh
+	const std::string path = CheckpointPath();
+	std::filesystem::remove(path);
+	std::ofstream(path).close();
+	std::filesystem::resize_file(path, 24);
+
+	{
+		ulid::PersistentGenerator generator(path, std::chrono::seconds(1), []() { return ts; });
+		ASSERT_EQ(0, generator.Mark());
+		generator.Next();
+	}
+
+	// anything else that is not a checkpoint is rejected
+	std::filesystem::resize_file(path, 25);
+	ASSERT_THROW(ulid::PersistentGenerator(path, std::chrono::seconds(1)), std::runtime_error);
+
+	std::filesystem::remove(path);
+}
+#endif
+
+TEST(FindAll, 1) {
+	const std::string text =
+			"{\"id\":\"01ARYZ6S410000000000000000\",\"parent\":\"0001C7STHC0G2081040G208104\"} "
+			"01ARYZ6S4100000000000000000 too long, 01ARYZ6S41000000000000000 too short, "
+			"81ARYZ6S410000000000000000 overflow, 01ARYZ6S41000000000000000I invalid\n"
+			"0001C7STHC0G2081040G208104";
+
+	std::vector<std::size_t> offsets;
+	std::vector<ulid::ULID> ulids;
+	std::size_t count = ulid::FindAll(text, [&](ulid::ULID ulid, std::size_t offset) {
+		ulids.push_back(ulid);
+		offsets.push_back(offset);
+	});
+
+	ASSERT_EQ(3, count);
+	ASSERT_EQ(ulid::Unmarshal("01ARYZ6S410000000000000000"), ulids[0]);
+	ASSERT_EQ(ulid::Unmarshal("0001C7STHC0G2081040G208104"), ulids[1]);
+	ASSERT_EQ(ulid::Unmarshal("0001C7STHC0G2081040G208104"), ulids[2]);
+	for (std::size_t i = 0; i < offsets.size(); i++) {
+		ASSERT_EQ(ulid::Marshal(ulids[i]), text.substr(offsets[i], ulid::STR_SIZE));
+	}
+
+	std::array<ulid::ULID, 2> out{};
+	ASSERT_EQ(3, ulid::FindAll(text, out));
+	ASSERT_EQ(ulids[0], out[0]);
+	ASSERT_EQ(ulids[1], out[1]);
+
+	ASSERT_EQ(0, ulid::FindAll("", out));
+}
+
+TEST(FindAll, 2) {
+	std::mt19937 generator(4);
+	std::uniform_int_distribution<int> separators(0, 3);
+
+	std::string text;
+	std::vector<ulid::ULID> expected;
+	for (int i = 0; i < 1000; i++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts, ulid);
+		ulid::EncodeEntropyMt19937(generator, ulid);
+		expected.push_back(ulid);
+
+		text += ulid::Marshal(ulid);
+		text += std::string(1 + separators(generator), " ,\"-"[separators(generator)]);
+	}
+
+	std::vector<ulid::ULID> got(expected.size());
+	ASSERT_EQ(expected.size(), ulid::FindAll(text, got));
+	ASSERT_EQ(expected, got);
+}
+
+TEST(MergeK, 1) {
+	std::mt19937 generator(4);
+	std::uniform_int_distribution<int> offsets(0, 1000);
+
+	std::vector<std::vector<ulid::ULID>> inputs(37);
+	std::vector<ulid::ULID> expected;
+	for (std::size_t i = 0; i < inputs.size(); i++) {
+		for (std::size_t j = 0; j < i * 7 % 50; j++) {
+			ulid::ULID ulid = 0;
+			ulid::EncodeTime(ts + std::chrono::milliseconds(offsets(generator)), ulid);
+			ulid::EncodeEntropy([]() { return 4; }, ulid);
+			inputs[i].push_back(ulid);
+			expected.push_back(ulid);
+		}
+		std::sort(inputs[i].begin(), inputs[i].end());
+	}
+	std::sort(expected.begin(), expected.end());
+
+	std::vector<std::span<const ulid::ULID>> spans(inputs.begin(), inputs.end());
+
+	std::vector<ulid::ULID> got(expected.size());
+	ASSERT_EQ(expected.size(), ulid::MergeK(spans, got));
+	ASSERT_EQ(expected, got);
+
+	expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+	ASSERT_EQ(expected.size(), ulid::MergeK(spans, got, true));
+	got.resize(expected.size());
+	ASSERT_EQ(expected, got);
+}
+
+TEST(LoserTree, 1) {
+	// pull based sources, drained in small batches
+	std::vector<std::function<bool(ulid::ULID&)>> sources;
+	for (int i = 0; i < 3; i++) {
+		sources.emplace_back([i, n = 0](ulid::ULID& ulid) mutable {
+			if (n == 5) {
+				return false;
+			}
+			ulid = static_cast<ulid::ULID>(n++ * 3 + i);
+			return true;
+		});
+	}
+	sources.emplace_back([](ulid::ULID&) { return false; });
+
+	ulid::LoserTree tree(std::move(sources));
+
+	std::vector<ulid::ULID> got;
+	std::array<ulid::ULID, 4> batch{};
+	while (std::size_t n = tree.Next(batch)) {
+		got.insert(got.end(), batch.begin(), batch.begin() + n);
+	}
+
+	ASSERT_EQ(15, got.size());
+	for (std::size_t i = 0; i < got.size(); i++) {
+		ASSERT_EQ(i, got[i]);
+	}
+}
+
+TEST(BinaryView, 1) {
+	ulid::ULID ulid = ulid::Create(ts, []() { return 4; });
+	std::vector<uint8_t> b = ulid::MarshalBinary(ulid);
+	ulid::BinaryView view(std::span<const uint8_t, ulid::BIN_SIZE>(b.data(), ulid::BIN_SIZE));
+
+	ASSERT_EQ(ulid, view.Load());
+	ASSERT_EQ(ulid::Time(ulid), view.Time());
+	ASSERT_EQ(ulid::Marshal(ulid), ulid::Marshal(view));
+
+	boost::uuids::uuid uuid = ulid::MarshalUuid(ulid);
+	ulid::BinaryView uuid_view(uuid);
+	ASSERT_EQ(view, uuid_view);
+	ASSERT_EQ(std::hash<ulid::BinaryView>()(view), std::hash<ulid::BinaryView>()(uuid_view));
+
+	std::vector<uint8_t> b2 = ulid::MarshalBinary(ulid + 1);
+	ulid::BinaryView view2(std::span<const uint8_t, ulid::BIN_SIZE>(b2.data(), ulid::BIN_SIZE));
+	ASSERT_LT(view, view2);
+	ASSERT_NE(view, view2);
+}
+
+TEST(StridedView, 1) {
+	// records of a 4 byte tag, the binary ULID and 4 bytes of padding
+	const std::size_t stride = 24;
+	const std::size_t offset = 4;
+
+	std::mt19937 generator(4);
+	std::vector<ulid::ULID> ulids;
+	std::vector<uint8_t> records;
+	for (int i = 0; i < 1000; i++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts + std::chrono::milliseconds(i), ulid);
+		ulid::EncodeEntropyMt19937(generator, ulid);
+		ulids.push_back(ulid);
+
+		std::vector<uint8_t> record(stride, 0xAB);
+		ulid::MarshalBinaryTo(ulid, std::span<uint8_t, ulid::BIN_SIZE>(record.data() + offset,
+																																	 ulid::BIN_SIZE));
+		records.insert(records.end(), record.begin(), record.end());
+	}
+
+	ulid::StridedView view(records, stride, offset);
+	ASSERT_EQ(ulids.size(), view.size());
+	static_assert(std::random_access_iterator<ulid::StridedView::Iterator>);
+
+	for (std::size_t i : {0, 1, 500, 999}) {
+		std::vector<uint8_t> key = ulid::MarshalBinary(ulids[i]);
+		auto it = std::ranges::lower_bound(
+				view, ulid::BinaryView(std::span<const uint8_t, ulid::BIN_SIZE>(key.data(),
+																																				ulid::BIN_SIZE)));
+		ASSERT_EQ(i, it - view.begin());
+		ASSERT_EQ(ulids[i], (*it).Load());
+	}
+
+	ASSERT_THROW(ulid::StridedView(records, 0), std::runtime_error);
+	ASSERT_THROW(ulid::StridedView(records, 16, 4), std::runtime_error);
+	ASSERT_THROW(ulid::StridedView(records, 24, 30), std::runtime_error);
+	ASSERT_EQ(0, ulid::StridedView({}, stride, offset).size());
+	ASSERT_TRUE(ulid::StridedView({}, stride, offset).begin() ==
+							ulid::StridedView({}, stride, offset).end());
+
+	std::vector<ulid::BinaryView> sorted(view.begin(), view.end());
+	std::reverse(sorted.begin(), sorted.end());
+	std::ranges::sort(sorted);
+	for (std::size_t i = 0; i < sorted.size(); i++) {
+		ASSERT_EQ(ulids[i], sorted[i].Load());
+	}
+}
+
+TEST(MutableStridedView, 1) {
+	// records of a 4 byte tag, the binary ULID and 4 bytes of padding
+	const std::size_t stride = 24;
+	const std::size_t offset = 4;
+
+	std::mt19937 generator(4);
+	std::vector<ulid::ULID> ulids;
+	std::vector<uint8_t> records;
+	for (uint32_t i = 0; i < 1000; i++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts + std::chrono::milliseconds(generator() % 100), ulid);
+		ulid::EncodeEntropyMt19937(generator, ulid);
+		ulids.push_back(ulid);
+
+		std::vector<uint8_t> record(stride, 0);
+		std::memcpy(record.data(), &i, sizeof(i));
+		ulid::MarshalBinaryTo(ulid, std::span<uint8_t, ulid::BIN_SIZE>(record.data() + offset,
+																																	 ulid::BIN_SIZE));
+		std::memcpy(record.data() + offset + ulid::BIN_SIZE, &i, sizeof(i));
+		records.insert(records.end(), record.begin(), record.end());
+	}
+
+	ulid::MutableStridedView view(records, stride, offset);
+	ASSERT_EQ(ulids.size(), view.size());
+	static_assert(std::sortable<ulid::MutableStridedView::Iterator>);
+
+	std::ranges::sort(view);
+
+	std::vector<ulid::ULID> sorted = ulids;
+	std::sort(sorted.begin(), sorted.end());
+	for (std::size_t i = 0; i < view.size(); i++) {
+		const ulid::MutableStridedView::Record record = view[i];
+		ASSERT_EQ(sorted[i], record.View().Load());
+
+		// the tag and padding moved along with their ULID
+		uint32_t tag = 0;
+		uint32_t padding = 0;
+		std::memcpy(&tag, record.bytes().data(), sizeof(tag));
+		std::memcpy(&padding, record.bytes().data() + offset + ulid::BIN_SIZE, sizeof(padding));
+		ASSERT_EQ(ulids[tag], sorted[i]);
+		ASSERT_EQ(tag, padding);
+	}
+
+	ulid::StridedView searchable(records, stride, offset);
+	ASSERT_TRUE(std::ranges::is_sorted(searchable));
+
+	ASSERT_THROW(ulid::MutableStridedView(records, 16, 4), std::runtime_error);
+	ASSERT_EQ(0, ulid::MutableStridedView({}, stride, offset).size());
+}
+
+TEST(StringGenerator, 1) {
+	auto now = ts;
+	ulid::StringGenerator generator(true, [&now]() { return now; });
+
+	std::string last = generator.Next();
+	ASSERT_EQ(ts, ulid::Time(ulid::Unmarshal(last)));
+
+	for (int i = 0; i < 1000; i++) {
+		std::array<char, ulid::STR_SIZE> str{};
+		generator.NextTo(str);
+		std::string next(str.data(), ulid::STR_SIZE);
+
+		ASSERT_EQ(last.substr(0, 10), next.substr(0, 10));
+		ASSERT_EQ(ulid::Unmarshal(last) + 1, ulid::Unmarshal(next));
+		last = next;
+	}
+
+	now -= std::chrono::seconds(1);
+	std::string next = generator.Next();
+	ASSERT_EQ(ulid::Unmarshal(last) + 1, ulid::Unmarshal(next));
+
+	now += std::chrono::seconds(2);
+	next = generator.Next();
+	ASSERT_EQ(ulid::MinStringForTime(now).substr(0, 10), next.substr(0, 10));
+	for (char c : next) {
+		ASSERT_NE(std::string::npos, encoding.find(c));
+	}
+}
+
+TEST(StringGenerator, 2) {
+	ulid::StringGenerator generator(false, []() { return ts; });
+
+	std::string first	 = generator.Next();
+	std::string second = generator.Next();
+	ASSERT_EQ(first.substr(0, 10), second.substr(0, 10));
+	ASSERT_EQ(ts, ulid::Time(ulid::Unmarshal(second)));
+	ASSERT_NE(first, second);
+}
+
+TEST(DistinctCounter, 1) {
+	ulid::Philox4x32 generator(4);
+
+	ulid::DistinctCounter counter;
+	ulid::DistinctCounter half1;
+	ulid::DistinctCounter half2;
+
+	std::vector<ulid::ULID> batch;
+	for (uint64_t n = 0; n < 200000; n++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts, ulid);
+		ulid::EncodeEntropyPhilox(generator, n, ulid);
+
+		// every ULID is added twice
+		counter.Add(ulid);
+		counter.Add(ulid);
+		(n % 2 == 0 ? half1 : half2).Add(ulid);
+		batch.push_back(ulid);
+
+		if (n == 999) {
+			ASSERT_TRUE(counter.IsSparse());
+			ASSERT_NEAR(1000, counter.Estimate(), 10);
+		}
+	}
+	ASSERT_FALSE(counter.IsSparse());
+	ASSERT_NEAR(200000, counter.Estimate(), 200000 * 0.03);
+
+	half1.Merge(half2);
+	ASSERT_EQ(counter.Estimate(), half1.Estimate());
+
+	ulid::DistinctCounter sparse;
+	sparse.Add(batch.front());
+	half1.Merge(sparse);
+	ASSERT_EQ(counter.Estimate(), half1.Estimate());
+	sparse.Merge(half1);
+	ASSERT_EQ(counter.Estimate(), sparse.Estimate());
+
+	ulid::DistinctCounter batched;
+	batched.Add(batch);
+	ASSERT_EQ(counter.Estimate(), batched.Estimate());
+
+	ASSERT_EQ(0, ulid::DistinctCounter().Estimate());
+	ASSERT_THROW(ulid::DistinctCounter(3), std::runtime_error);
+	ASSERT_THROW(half1.Merge(ulid::DistinctCounter(10)), std::runtime_error);
+}
+
+TEST(WindowedDistinctCounter, 1) {
+	ulid::Philox4x32 generator(4);
+
+	std::vector<ulid::ULID> ulids;
+	for (uint64_t n = 0; n < 30000; n++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts + std::chrono::milliseconds(n / 10), ulid);	// 10 per ms
+		ulid::EncodeEntropyPhilox(generator, n, ulid);
+		ulids.push_back(ulid);
+	}
+
+	ulid::WindowedDistinctCounter counter(std::chrono::seconds(1));
+	counter.Add(std::span<const ulid::ULID>(ulids).first(15000));
+
+	ulid::WindowedDistinctCounter rest(std::chrono::seconds(1));
+	rest.Add(std::span<const ulid::ULID>(ulids).subspan(15000));
+	counter.Merge(rest);
+
+	ASSERT_EQ(3, counter.windows().size());
+	for (int s = 0; s < 3; s++) {
+		ASSERT_NEAR(10000, counter.Estimate(ts + std::chrono::seconds(s)), 10000 * 0.03);
+	}
+	ASSERT_EQ(0, counter.Estimate(ts + std::chrono::seconds(3)));
+}
+
+TEST(UuidV7, 1) {
+	ulid::ULID ulid = ulid::CreateUuidV7(ts, []() { return 0xFF; });
+	ASSERT_TRUE(ulid::IsUuidV7(ulid));
+	ASSERT_EQ(ts, ulid::Time(ulid));
+
+	boost::uuids::uuid uuid = ulid::MarshalUuid(ulid);
+	ASSERT_EQ(0x70, uuid.begin()[6] & 0xF0);
+	ASSERT_EQ(0x80, uuid.begin()[8] & 0xC0);
+
+	ASSERT_FALSE(ulid::IsUuidV7(ulid::Create(ts, []() { return 0xFF; })));
+	ASSERT_TRUE(ulid::IsUuidV7(ulid::CreateNowRandUuidV7()));
+}
+
+TEST(UuidV7, 2) {
+	std::vector<ulid::ULID> ulids;
+	for (int i = 0; i < 100; i++) {
+		ulids.push_back(ulid::Create(ts + std::chrono::milliseconds(i), [i]() { return i; }));
+	}
+
+	std::vector<boost::uuids::uuid> uuids(ulids.size());
+	ulid::MarshalUuidV7(ulids, uuids);
+
+	std::vector<ulid::ULID> got(uuids.size());
+	ulid::UnmarshalUuids(uuids, got);
+
+	for (std::size_t i = 0; i < ulids.size(); i++) {
+		ASSERT_TRUE(ulid::IsUuidV7(got[i]));
+		ASSERT_EQ(ulid::Time(ulids[i]), ulid::Time(got[i]));
+		if (i > 0) {
+			ASSERT_EQ(-1, ulid::CompareULIDs(got[i - 1], got[i]));
+		}
+	}
+
+	// the version and variant bits replace entropy of a plain ULID
+	ASSERT_NE(ulids[1], got[1]);
+
+	ASSERT_THROW(ulid::MarshalUuidV7(ulids, std::span(uuids).first(1)), std::runtime_error);
+	ASSERT_THROW(ulid::UnmarshalUuids(uuids, std::span(got).first(1)), std::runtime_error);
+}
+
+TEST(FindTimeRange, 2) {
+	// heavily skewed timestamps fall back to binary search
+	std::mt19937 generator(4);
+	std::exponential_distribution<double> offsets(0.001);
+
+	std::vector<ulid::ULID> ulids;
+	for (int i = 0; i < 20000; i++) {
+		ulid::ULID ulid = 0;
+		ulid::EncodeTime(ts + std::chrono::milliseconds(static_cast<int64_t>(offsets(generator) *
+																																				 offsets(generator))),
+										 ulid);
+		ulid::EncodeEntropyMt19937(generator, ulid);
+		ulids.push_back(ulid);
+	}
+	std::sort(ulids.begin(), ulids.end());
+
+	for (int i = 0; i < 200; i++) {
+		const ulid::ULID key = ulids[static_cast<std::size_t>(generator()) % ulids.size()] + i % 3 - 1;
+		ASSERT_EQ(std::lower_bound(ulids.begin(), ulids.end(), key) - ulids.begin(),
+							ulid::InterpolationLowerBound(ulids, key));
+	}
+}
+
+TEST(GenerateParallel, 2) {
+	auto timestamp_fn = [](std::size_t i) {
+		if (i == 7000) {
+			throw std::runtime_error("timestamp");
+		}
+		return ts;
+	};
+
+	std::vector<ulid::ULID> ulids(10007);
+	for (unsigned threads : {1U, 4U}) {
+		ASSERT_THROW(ulid::GenerateParallel(ulids, 4, timestamp_fn, threads), std::runtime_error);
+	}
+}
+
+TEST(FindAll, 3) {
+	// every offset around the 64 character blocks, next to runs of 25 and 27
+	const std::string str = "01ARYZ6S410000000000000000";
+	for (std::size_t offset = 0; offset < 200; offset++) {
+		for (std::size_t neighbour : {25, 27}) {
+			std::string text(offset, '-');
+			text += str + "-" + std::string(neighbour, 'A');
+			if (offset > neighbour) {
+				text.replace(0, neighbour, neighbour, '7');
+			}
+
+			std::vector<std::size_t> offsets;
+			ulid::FindAll(text, [&](ulid::ULID, std::size_t at) { offsets.push_back(at); });
+			ASSERT_EQ(std::vector<std::size_t>{offset}, offsets);
+		}
+	}
+}
+
+TEST(AlphabetMask, 1) {
+	for (int c = 0; c < 256; c++) {
+		for (std::size_t len : {64, 63, 15, 9, 1}) {
+			std::string str(len, '-');
+			for (std::size_t i = c % 3; i < len; i += 3) {
+				str[i] = static_cast<char>(c);
+			}
+
+			uint64_t expected = 0;
+			for (std::size_t i = 0; i < len; i++) {
+				expected |= static_cast<uint64_t>(ulid::dec[static_cast<uint8_t>(str[i])] != 0xFF) << i;
+			}
+			ASSERT_EQ(expected, ulid::AlphabetMask(str.data(), len));
+		}
+	}
+}
+
+TEST(MergeK, 2) {
+	// the largest ULID sorts before exhausted sources
+	const ulid::ULID max = ~static_cast<ulid::ULID>(0);
+	std::vector<ulid::ULID> a = {1, max};
+	std::vector<ulid::ULID> b = {};
+	std::vector<ulid::ULID> c = {max, max};
+	std::vector<std::span<const ulid::ULID>> spans = {b, a, c};
+
+	std::vector<ulid::ULID> got(4);
+	ASSERT_EQ(4, ulid::MergeK(spans, got));
+	ASSERT_EQ((std::vector<ulid::ULID>{1, max, max, max}), got);
+	ASSERT_EQ(2, ulid::MergeK(spans, got, true));
+
+	ASSERT_EQ(0, ulid::MergeK({}, got));
+}
+
+TEST(DistinctCounter, 2) {
+	// the switch to dense registers does not depend on how ULIDs are added
+	ulid::Philox4x32 generator(4);
+
+	for (uint8_t precision : {4, 10, 14}) {
+		for (std::size_t n : {3, 200, 4096, 4097, 5000}) {
+			std::vector<ulid::ULID> ulids(n);
+			for (std::size_t i = 0; i < n; i++) {
+				ulid::EncodeEntropyPhilox(generator, n * precision + i, ulids[i]);
+			}
+
+			ulid::DistinctCounter single(precision);
+			for (const ulid::ULID& ulid : ulids) {
+				single.Add(ulid);
+			}
+
+			ulid::DistinctCounter batched(precision);
+			batched.Add(ulids);
+
+			ulid::DistinctCounter merged(precision);
+			merged.Merge(single);
+
+			ASSERT_EQ(single.Estimate(), batched.Estimate());
+			ASSERT_EQ(single.Estimate(), merged.Estimate());
+		}
+	}
+}
+
+TEST(DistinctCounter, 3) {
+	// repeats of about SparseLimit distinct ULIDs neither change the estimate
+	// nor keep the counter sparse past the limit
+	ulid::Philox4x32 generator(5);
+
+	for (std::size_t n : {4090, 4096, 4200}) {
+		std::vector<ulid::ULID> ulids(n);
+		for (std::size_t i = 0; i < n; i++) {
+			ulid::EncodeEntropyPhilox(generator, n + i, ulids[i]);
+		}
+
+		ulid::DistinctCounter once(14);
+		once.Add(ulids);
+
+		ulid::DistinctCounter repeated(14);
+		for (int pass = 0; pass < 50; pass++) {
+			for (const ulid::ULID& ulid : ulids) {
+				repeated.Add(ulid);
+			}
+		}
+
+		ASSERT_EQ(once.Estimate(), repeated.Estimate());
+		if (n > 4100) {
+			ASSERT_FALSE(repeated.IsSparse());
+		}
+	}
+
+	ulid::ULID ulid = 0;
+	ulid::EncodeEntropyPhilox(generator, 0, ulid);
+	ulid::DistinctCounter counter(14);
+	counter.Add(ulid);
+	const uint64_t estimate = counter.Estimate();
+	counter.Merge(counter);
+	ASSERT_EQ(estimate, counter.Estimate());
+}